@@ -0,0 +1,710 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* bench/bench.c - Hash, HMAC, and OTP microbenchmarks                        */
+/*----------------------------------------------------------------------------*/
+
+/* required for clock_gettime() in strict C89 mode */
+#define _POSIX_C_SOURCE 199309L
+
+#include "cliauth.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cpu.h"
+#include "endian.h"
+#include "hash.h"
+#include "mac.h"
+#include "otp.h"
+#include "verify.h"
+
+/* number of timed samples taken for each benchmark.  with nearest-rank */
+/* percentiles, this is the fewest samples where the 99th percentile isn't */
+/* simply the slowest sample. */
+#define CLIAUTH_BENCH_SAMPLES 201
+
+/* minimum duration of a single sample.  the number of iterations per sample */
+/* is doubled until a sample takes at least this long, which keeps the timer */
+/* resolution from dominating very short operations. */
+#define CLIAUTH_BENCH_SAMPLE_NANOSECONDS_MIN 50000.0
+
+/* message lengths used for the raw hash benchmarks.  8 bytes is the length */
+/* of an OTP counter. */
+static const CliAuthUInt32
+cliauth_bench_message_lengths [] = {
+   8, 64, 1024, 1048576
+};
+
+#define CLIAUTH_BENCH_MESSAGE_LENGTHS_COUNT (\
+      sizeof(cliauth_bench_message_lengths) /\
+      sizeof(cliauth_bench_message_lengths[0])\
+   )
+
+#define CLIAUTH_BENCH_MESSAGE_LENGTH_MAX 1048576
+
+/* length of the key used for the HMAC and OTP benchmarks, which is the */
+/* length recommended by RFC 4226 */
+#define CLIAUTH_BENCH_KEY_LENGTH 20
+
+/* parameters of the TOTP accounts used for the verification benchmarks */
+#define CLIAUTH_BENCH_TOTP_INTERVAL 30
+#define CLIAUTH_BENCH_TOTP_LEAD 2
+
+/* number of accounts in the verification table benchmark */
+#define CLIAUTH_BENCH_ACCOUNTS 1024
+
+struct CliAuthBenchHash {
+   const char * name;
+   const struct CliAuthHashFunction * function;
+   CliAuthUInt32 block_bytes;
+   CliAuthUInt32 digest_bytes;
+};
+
+static const struct CliAuthBenchHash
+cliauth_bench_hashes [] = {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   {
+      "sha1",
+      &cliauth_hash_sha1,
+      CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA1_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if CLIAUTH_CONFIG_HASH_SHA224
+   {
+      "sha224",
+      &cliauth_hash_sha224,
+      CLIAUTH_HASH_SHA224_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA224_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
+#if CLIAUTH_CONFIG_HASH_SHA256
+   {
+      "sha256",
+      &cliauth_hash_sha256,
+      CLIAUTH_HASH_SHA256_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA256_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
+#if CLIAUTH_CONFIG_HASH_SHA384
+   {
+      "sha384",
+      &cliauth_hash_sha384,
+      CLIAUTH_HASH_SHA384_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA384_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
+#if CLIAUTH_CONFIG_HASH_SHA512
+   {
+      "sha512",
+      &cliauth_hash_sha512,
+      CLIAUTH_HASH_SHA512_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA512_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
+#if CLIAUTH_CONFIG_HASH_SHA512_224
+   {
+      "sha512/224",
+      &cliauth_hash_sha512_224,
+      CLIAUTH_HASH_SHA512_224_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
+#if CLIAUTH_CONFIG_HASH_SHA512_256
+   {
+      "sha512/256",
+      &cliauth_hash_sha512_256,
+      CLIAUTH_HASH_SHA512_256_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
+};
+
+#define CLIAUTH_BENCH_HASHES_COUNT\
+   (sizeof(cliauth_bench_hashes) / sizeof(cliauth_bench_hashes[0]))
+
+/* output formats for the results */
+enum CliAuthBenchFormat {
+   CLIAUTH_BENCH_FORMAT_CSV,
+   CLIAUTH_BENCH_FORMAT_JSON
+};
+
+/* the operations which can be benchmarked */
+enum CliAuthBenchOperation {
+   /* initialize, digest, and finalize a message */
+   CLIAUTH_BENCH_OPERATION_HASH,
+
+   /* HMAC of an OTP counter, preparing the key every time */
+   CLIAUTH_BENCH_OPERATION_HMAC,
+
+   /* HMAC of an OTP counter using a key prepared ahead of time */
+   CLIAUTH_BENCH_OPERATION_HMAC_PREPARED,
+
+   /* a full 6-digit HOTP passcode */
+   CLIAUTH_BENCH_OPERATION_HOTP,
+
+   /* verifying a 6-digit TOTP passcode, computing the steps on demand */
+   CLIAUTH_BENCH_OPERATION_TOTP_VERIFY,
+
+   /* verifying a 6-digit TOTP passcode with a verification table */
+   CLIAUTH_BENCH_OPERATION_TOTP_VERIFY_TABLE
+};
+
+/* everything needed to run one operation repeatedly */
+struct CliAuthBenchState {
+   const struct CliAuthBenchHash * hash;
+   enum CliAuthBenchOperation operation;
+   CliAuthUInt32 message_bytes;
+   const CliAuthUInt8 * message;
+   const CliAuthUInt8 * key;
+   struct CliAuthMacHmacKey hmac_key;
+   struct CliAuthOtpBuffersGeneric buffers;
+   void * hash_contexts [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthVerifyTable * verify_table;
+   CliAuthBoolean verify_table_refresh;
+   CliAuthUInt64 verify_table_time_refresh;
+   CliAuthUInt64 counter;
+};
+
+/* summary statistics for one benchmark in nanoseconds per operation.  each */
+/* sample is the mean time of an operation over all of the sample's */
+/* iterations, so the percentiles are over these per-sample means, not the */
+/* latencies of individual operations. */
+struct CliAuthBenchResult {
+   CliAuthUInt32 iterations;
+   double minimum;
+   double median;
+   double percentile_90;
+   double percentile_99;
+   double maximum;
+};
+
+/* accumulates outputs so the compiler can't discard the benchmarked work */
+static volatile CliAuthUInt32
+cliauth_bench_sink;
+
+static double
+cliauth_bench_now(void) {
+   struct timespec now;
+
+   (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+   return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+static const char *
+cliauth_bench_operation_name(enum CliAuthBenchOperation operation) {
+   switch (operation) {
+      case CLIAUTH_BENCH_OPERATION_HASH:
+         return "hash";
+      case CLIAUTH_BENCH_OPERATION_HMAC:
+         return "hmac";
+      case CLIAUTH_BENCH_OPERATION_HMAC_PREPARED:
+         return "hmac-prepared";
+      case CLIAUTH_BENCH_OPERATION_HOTP:
+         return "hotp";
+      case CLIAUTH_BENCH_OPERATION_TOTP_VERIFY:
+         return "totp-verify";
+      case CLIAUTH_BENCH_OPERATION_TOTP_VERIFY_TABLE:
+         return "totp-verify-table";
+   }
+
+   return "unknown";
+}
+
+static void
+cliauth_bench_run_once(struct CliAuthBenchState * state) {
+   const struct CliAuthBenchHash * hash;
+   CliAuthUInt8 * digest;
+   CliAuthUInt64 counter_big_endian;
+   CliAuthUInt64 time_current;
+   CliAuthSInt64 step_matched;
+   CliAuthUInt32 passcode;
+   CliAuthBoolean verified;
+
+   hash = state->hash;
+   digest = (CliAuthUInt8 *)&state->buffers.digest_buffer;
+
+   switch (state->operation) {
+      case CLIAUTH_BENCH_OPERATION_HASH:
+         hash->function->initialize(&state->buffers.hash_context);
+         hash->function->digest(
+            &state->buffers.hash_context,
+            state->message,
+            state->message_bytes
+         );
+         hash->function->finalize(&state->buffers.hash_context, digest);
+         cliauth_bench_sink += digest[0];
+         break;
+
+      case CLIAUTH_BENCH_OPERATION_HMAC:
+         counter_big_endian = cliauth_endian_host_to_big_uint64(state->counter);
+         cliauth_mac_hmac(
+            hash->function,
+            &state->buffers.hash_context,
+            &counter_big_endian,
+            state->key,
+            &state->buffers.key_buffer,
+            digest,
+            sizeof(counter_big_endian),
+            CLIAUTH_BENCH_KEY_LENGTH,
+            hash->block_bytes,
+            hash->digest_bytes
+         );
+         cliauth_bench_sink += digest[0];
+         state->counter++;
+         break;
+
+      case CLIAUTH_BENCH_OPERATION_HMAC_PREPARED:
+         counter_big_endian = cliauth_endian_host_to_big_uint64(state->counter);
+         cliauth_mac_hmac_prepared(
+            &state->hmac_key,
+            &state->buffers.hash_context,
+            &counter_big_endian,
+            digest,
+            sizeof(counter_big_endian)
+         );
+         cliauth_bench_sink += digest[0];
+         state->counter++;
+         break;
+
+      case CLIAUTH_BENCH_OPERATION_HOTP:
+         passcode = cliauth_otp_hotp(
+            hash->function,
+            &state->buffers.hash_context,
+            state->key,
+            &state->buffers.digest_buffer,
+            &state->buffers.key_buffer,
+            CLIAUTH_BENCH_KEY_LENGTH,
+            hash->block_bytes,
+            hash->digest_bytes,
+            state->counter,
+            6
+         );
+         cliauth_bench_sink += passcode;
+         state->counter++;
+         break;
+
+      case CLIAUTH_BENCH_OPERATION_TOTP_VERIFY:
+         verified = cliauth_otp_totp_verify(
+            &state->hmac_key,
+            state->hash_contexts,
+            &step_matched,
+            0,
+            (CliAuthUInt64)time(CLIAUTH_NULLPTR),
+            CLIAUTH_BENCH_TOTP_INTERVAL,
+            (CliAuthUInt32)(state->counter % 1000000),
+            1,
+            6
+         );
+         cliauth_bench_sink += (CliAuthUInt32)verified;
+         state->counter++;
+         break;
+
+      case CLIAUTH_BENCH_OPERATION_TOTP_VERIFY_TABLE:
+         time_current = (CliAuthUInt64)time(CLIAUTH_NULLPTR);
+
+         /* without a background thread, the owner refreshes the table */
+         if (
+            state->verify_table_refresh == CLIAUTH_BOOLEAN_TRUE &&
+            time_current >= state->verify_table_time_refresh
+         ) {
+            state->verify_table_time_refresh = cliauth_verify_table_refresh(
+               state->verify_table,
+               state->hash_contexts,
+               time_current
+            );
+         }
+
+         verified = cliauth_verify_table_lookup(
+            state->verify_table,
+            state->hash_contexts,
+            &step_matched,
+            (CliAuthUInt32)(state->counter % CLIAUTH_BENCH_ACCOUNTS),
+            time_current,
+            (CliAuthUInt32)(state->counter % 1000000)
+         );
+         cliauth_bench_sink += (CliAuthUInt32)verified;
+         state->counter++;
+         break;
+   }
+
+   return;
+}
+
+/* runs the operation 'iterations' times, returning the elapsed nanoseconds */
+static double
+cliauth_bench_run_sample(
+   struct CliAuthBenchState * state,
+   CliAuthUInt32 iterations
+) {
+   double start;
+
+   start = cliauth_bench_now();
+   while (iterations != 0) {
+      cliauth_bench_run_once(state);
+      iterations--;
+   }
+
+   return cliauth_bench_now() - start;
+}
+
+static int
+cliauth_bench_compare_doubles(const void * lhs, const void * rhs) {
+   double a, b;
+
+   a = *(const double *)lhs;
+   b = *(const double *)rhs;
+
+   if (a < b) {
+      return -1;
+   }
+   if (a > b) {
+      return 1;
+   }
+   return 0;
+}
+
+/* nearest-rank percentile of a sorted array of samples */
+static double
+cliauth_bench_percentile(
+   const double samples [],
+   CliAuthUInt32 count,
+   CliAuthUInt32 percentile
+) {
+   return samples[((count - 1) * percentile + 50) / 100];
+}
+
+static void
+cliauth_bench_measure(
+   struct CliAuthBenchState * state,
+   struct CliAuthBenchResult * result
+) {
+   double samples [CLIAUTH_BENCH_SAMPLES];
+   CliAuthUInt32 iterations;
+   CliAuthUInt32 i;
+
+   /* warm up the caches and find an iteration count which makes each */
+   /* sample long enough to time accurately */
+   iterations = 1;
+   while (
+      cliauth_bench_run_sample(state, iterations) <
+      CLIAUTH_BENCH_SAMPLE_NANOSECONDS_MIN
+   ) {
+      iterations *= 2;
+   }
+
+   i = 0;
+   while (i != CLIAUTH_BENCH_SAMPLES) {
+      samples[i] =
+         cliauth_bench_run_sample(state, iterations) / (double)iterations;
+      i++;
+   }
+
+   qsort(
+      samples,
+      CLIAUTH_BENCH_SAMPLES,
+      sizeof(samples[0]),
+      cliauth_bench_compare_doubles
+   );
+
+   result->iterations = iterations;
+   result->minimum = samples[0];
+   result->median =
+      cliauth_bench_percentile(samples, CLIAUTH_BENCH_SAMPLES, 50);
+   result->percentile_90 =
+      cliauth_bench_percentile(samples, CLIAUTH_BENCH_SAMPLES, 90);
+   result->percentile_99 =
+      cliauth_bench_percentile(samples, CLIAUTH_BENCH_SAMPLES, 99);
+   result->maximum = samples[CLIAUTH_BENCH_SAMPLES - 1];
+
+   return;
+}
+
+static void
+cliauth_bench_print_header(enum CliAuthBenchFormat format) {
+   switch (format) {
+      case CLIAUTH_BENCH_FORMAT_CSV:
+         (void)printf(
+            "operation,hash,bytes,samples,iterations,"
+            "ns_min,ns_p50,ns_p90,ns_p99,ns_max,mib_per_s\n"
+         );
+         break;
+      case CLIAUTH_BENCH_FORMAT_JSON:
+         (void)printf("[\n");
+         break;
+   }
+
+   return;
+}
+
+static void
+cliauth_bench_print_footer(enum CliAuthBenchFormat format) {
+   switch (format) {
+      case CLIAUTH_BENCH_FORMAT_CSV:
+         break;
+      case CLIAUTH_BENCH_FORMAT_JSON:
+         (void)printf("\n]\n");
+         break;
+   }
+
+   return;
+}
+
+static void
+cliauth_bench_print_result(
+   enum CliAuthBenchFormat format,
+   const struct CliAuthBenchState * state,
+   const struct CliAuthBenchResult * result,
+   CliAuthBoolean first
+) {
+   const char * operation;
+   double throughput;
+
+   operation = cliauth_bench_operation_name(state->operation);
+
+   /* throughput at the median latency, in MiB of message per second */
+   throughput =
+      ((double)state->message_bytes / 1048576.0) / (result->median / 1e9);
+
+   switch (format) {
+      case CLIAUTH_BENCH_FORMAT_CSV:
+         (void)printf(
+            "%s,%s,%lu,%d,%lu,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f\n",
+            operation,
+            state->hash->name,
+            (unsigned long)state->message_bytes,
+            CLIAUTH_BENCH_SAMPLES,
+            (unsigned long)result->iterations,
+            result->minimum,
+            result->median,
+            result->percentile_90,
+            result->percentile_99,
+            result->maximum,
+            throughput
+         );
+         break;
+      case CLIAUTH_BENCH_FORMAT_JSON:
+         if (first == CLIAUTH_BOOLEAN_FALSE) {
+            (void)printf(",\n");
+         }
+         (void)printf(
+            "  {\"operation\": \"%s\", \"hash\": \"%s\", \"bytes\": %lu, "
+            "\"samples\": %d, \"iterations\": %lu, \"ns_min\": %.1f, "
+            "\"ns_p50\": %.1f, \"ns_p90\": %.1f, \"ns_p99\": %.1f, "
+            "\"ns_max\": %.1f, \"mib_per_s\": %.2f}",
+            operation,
+            state->hash->name,
+            (unsigned long)state->message_bytes,
+            CLIAUTH_BENCH_SAMPLES,
+            (unsigned long)result->iterations,
+            result->minimum,
+            result->median,
+            result->percentile_90,
+            result->percentile_99,
+            result->maximum,
+            throughput
+         );
+         break;
+   }
+
+   (void)fflush(stdout);
+
+   return;
+}
+
+static void
+cliauth_bench_run(
+   enum CliAuthBenchFormat format,
+   struct CliAuthBenchState * state,
+   CliAuthBoolean * first
+) {
+   struct CliAuthBenchResult result;
+
+   cliauth_bench_measure(state, &result);
+   cliauth_bench_print_result(format, state, &result, *first);
+   *first = CLIAUTH_BOOLEAN_FALSE;
+
+   return;
+}
+
+/* benchmarks lookups into a verification table of CLIAUTH_BENCH_ACCOUNTS */
+/* accounts sharing the prepared key of the current hash.  with threads, */
+/* the table is refreshed in the background while it is measured, the same */
+/* as in a long-running verifier. */
+static void
+cliauth_bench_run_verify_table(
+   enum CliAuthBenchFormat format,
+   struct CliAuthBenchState * state,
+   CliAuthBoolean * first
+) {
+   static struct CliAuthMacHmacKey hmac_keys [CLIAUTH_BENCH_ACCOUNTS];
+   static CliAuthUInt64 time_initial [CLIAUTH_BENCH_ACCOUNTS];
+   static CliAuthUInt64 time_interval [CLIAUTH_BENCH_ACCOUNTS];
+   static CliAuthUInt8 digits [CLIAUTH_BENCH_ACCOUNTS];
+   static struct CliAuthVerifyTableRow rows_front [CLIAUTH_BENCH_ACCOUNTS];
+   static struct CliAuthVerifyTableRow rows_back [CLIAUTH_BENCH_ACCOUNTS];
+   static struct CliAuthVerifyTable table;
+   struct CliAuthOtpTotpTable accounts;
+   CliAuthUInt64 time_current;
+   CliAuthUInt32 i;
+
+   i = 0;
+   while (i != CLIAUTH_BENCH_ACCOUNTS) {
+      hmac_keys[i] = state->hmac_key;
+      time_initial[i] = 0;
+      time_interval[i] = CLIAUTH_BENCH_TOTP_INTERVAL;
+      digits[i] = 6;
+      i++;
+   }
+
+   accounts.hmac_keys = hmac_keys;
+   accounts.time_initial = time_initial;
+   accounts.time_interval = time_interval;
+   accounts.digits = digits;
+   accounts.count = CLIAUTH_BENCH_ACCOUNTS;
+
+   time_current = (CliAuthUInt64)time(CLIAUTH_NULLPTR);
+   cliauth_verify_table_initialize(
+      &table,
+      &accounts,
+      rows_front,
+      rows_back,
+      state->hash_contexts,
+      time_current,
+      CLIAUTH_BENCH_TOTP_LEAD
+   );
+
+   state->verify_table = &table;
+   state->verify_table_refresh = CLIAUTH_BOOLEAN_TRUE;
+   state->verify_table_time_refresh = time_current;
+#if CLIAUTH_CONFIG_THREADS
+   if (cliauth_verify_table_start(&table) == CLIAUTH_BOOLEAN_TRUE) {
+      state->verify_table_refresh = CLIAUTH_BOOLEAN_FALSE;
+   }
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   state->operation = CLIAUTH_BENCH_OPERATION_TOTP_VERIFY_TABLE;
+   cliauth_bench_run(format, state, first);
+
+#if CLIAUTH_CONFIG_THREADS
+   if (state->verify_table_refresh == CLIAUTH_BOOLEAN_FALSE) {
+      cliauth_verify_table_stop(&table);
+   }
+#endif /* CLIAUTH_CONFIG_THREADS */
+   cliauth_verify_table_destroy(&table);
+   state->verify_table = CLIAUTH_NULLPTR;
+
+   return;
+}
+
+static void
+cliauth_bench_print_usage(const char * program) {
+   (void)fprintf(stderr, "usage: %s [--csv | --json]\n", program);
+   return;
+}
+
+int
+main(int argc, char * argv []) {
+   static CliAuthUInt8 message [CLIAUTH_BENCH_MESSAGE_LENGTH_MAX];
+   static struct CliAuthBenchState state;
+   static union CliAuthOtpBuffersGenericHashContext
+      hash_contexts [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt8 key [CLIAUTH_BENCH_KEY_LENGTH];
+   enum CliAuthBenchFormat format;
+   CliAuthBoolean first;
+   CliAuthUInt32 i, j;
+
+   format = CLIAUTH_BENCH_FORMAT_CSV;
+   if (argc > 2) {
+      cliauth_bench_print_usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+   if (argc == 2) {
+      if (strcmp(argv[1], "--csv") == 0) {
+         format = CLIAUTH_BENCH_FORMAT_CSV;
+      } else if (strcmp(argv[1], "--json") == 0) {
+         format = CLIAUTH_BENCH_FORMAT_JSON;
+      } else {
+         cliauth_bench_print_usage(argv[0]);
+         return EXIT_FAILURE;
+      }
+   }
+
+   cliauth_cpu_initialize();
+   cliauth_hash_initialize();
+
+   i = 0;
+   while (i != CLIAUTH_BENCH_MESSAGE_LENGTH_MAX) {
+      message[i] = (CliAuthUInt8)(i * 7 + 3);
+      i++;
+   }
+   i = 0;
+   while (i != CLIAUTH_BENCH_KEY_LENGTH) {
+      key[i] = (CliAuthUInt8)(i * 5 + 1);
+      i++;
+   }
+
+   state.message = message;
+   state.key = key;
+   state.counter = 0;
+   first = CLIAUTH_BOOLEAN_TRUE;
+
+   i = 0;
+   while (i != CLIAUTH_HASH_LANES_MAX) {
+      state.hash_contexts[i] = &hash_contexts[i];
+      i++;
+   }
+
+   cliauth_bench_print_header(format);
+
+   i = 0;
+   while (i != CLIAUTH_BENCH_HASHES_COUNT) {
+      state.hash = &cliauth_bench_hashes[i];
+
+      state.operation = CLIAUTH_BENCH_OPERATION_HASH;
+      j = 0;
+      while (j != CLIAUTH_BENCH_MESSAGE_LENGTHS_COUNT) {
+         state.message_bytes = cliauth_bench_message_lengths[j];
+         cliauth_bench_run(format, &state, &first);
+         j++;
+      }
+
+      /* the remaining operations all authenticate an 8-byte OTP counter */
+      state.message_bytes = sizeof(state.counter);
+
+      state.operation = CLIAUTH_BENCH_OPERATION_HMAC;
+      cliauth_bench_run(format, &state, &first);
+
+      cliauth_mac_hmac_key_initialize(
+         &state.hmac_key,
+         state.hash->function,
+         &state.buffers.hash_context,
+         key,
+         &state.buffers.key_buffer,
+         CLIAUTH_BENCH_KEY_LENGTH,
+         state.hash->block_bytes,
+         state.hash->digest_bytes
+      );
+      state.operation = CLIAUTH_BENCH_OPERATION_HMAC_PREPARED;
+      cliauth_bench_run(format, &state, &first);
+
+      state.operation = CLIAUTH_BENCH_OPERATION_HOTP;
+      cliauth_bench_run(format, &state, &first);
+
+      state.operation = CLIAUTH_BENCH_OPERATION_TOTP_VERIFY;
+      cliauth_bench_run(format, &state, &first);
+
+      cliauth_bench_run_verify_table(format, &state, &first);
+
+      i++;
+   }
+
+   cliauth_bench_print_footer(format);
+
+   return EXIT_SUCCESS;
+}
+
@@ -29,9 +29,131 @@ cliauth_args_parse_key_uri_error_name [CLIAUTH_PARSE_KEY_URI_RESULT_FIELD_COUNT]
    "the issuer and account name label string is too long",
    "the issuer string is too long",
    "the account name string is too long",
-   "the base-32 secrets string is too long"
+   "the base-32 secrets string is too long",
+   "the key URI is too long"
 };
 
+#define CLIAUTH_ARGS_OPTION_FROM   "--from"
+#define CLIAUTH_ARGS_OPTION_TO     "--to"
+#define CLIAUTH_ARGS_OPTION_COUNT  "--count"
+#define CLIAUTH_ARGS_OPTION_IMPORT "--import"
+
+/* gets the value which follows the option at 'index' */
+static enum CliAuthArgsParseResult
+cliauth_args_parse_option_value(
+   const char * * output,
+   const char * const args [],
+   CliAuthUInt16 args_count,
+   CliAuthUInt16 index
+) {
+   if (index + 1 >= args_count) {
+      cliauth_log(CLIAUTH_LOG_ERROR("no value was given for %s"), args[index]);
+      return CLIAUTH_ARGS_PARSE_RESULT_MISSING;
+   }
+
+   *output = args[index + 1];
+
+   return CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+}
+
+/* parses the integer value which follows the option at 'index' */
+static enum CliAuthArgsParseResult
+cliauth_args_parse_option_uint64(
+   CliAuthUInt64 * output,
+   const char * const args [],
+   CliAuthUInt16 args_count,
+   CliAuthUInt16 index
+) {
+   enum CliAuthArgsParseResult result;
+   const char * value;
+
+   result = cliauth_args_parse_option_value(&value, args, args_count, index);
+   if (result != CLIAUTH_ARGS_PARSE_RESULT_SUCCESS) {
+      return result;
+   }
+
+   if (cliauth_parse_integer_uint64(
+      output,
+      value,
+      strlen(value)
+   ) != CLIAUTH_PARSE_INTEGER_RESULT_SUCCESS) {
+      cliauth_log(CLIAUTH_LOG_ERROR("invalid value for %s: %s"), args[index], value);
+      return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+   }
+
+   return CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+}
+
+/* validates the range options against the parsed key URI's algorithm */
+static enum CliAuthArgsParseResult
+cliauth_args_parse_range(
+   struct CliAuthArgsPayload * payload,
+   CliAuthBoolean has_from,
+   CliAuthBoolean has_to,
+   CliAuthBoolean has_count,
+   CliAuthUInt64 time_from,
+   CliAuthUInt64 time_to
+) {
+   payload->range = CLIAUTH_BOOLEAN_FALSE;
+
+   switch (payload->uri.algorithm) {
+      case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_HOTP:
+         if (has_from == CLIAUTH_BOOLEAN_TRUE || has_to == CLIAUTH_BOOLEAN_TRUE) {
+            cliauth_log(CLIAUTH_LOG_ERROR("%s and %s can only be used with the TOTP algorithm"), CLIAUTH_ARGS_OPTION_FROM, CLIAUTH_ARGS_OPTION_TO);
+            return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+         }
+
+         if (has_count == CLIAUTH_BOOLEAN_FALSE) {
+            break;
+         }
+
+         if (payload->count == 0) {
+            cliauth_log(CLIAUTH_LOG_ERROR("%s must be at least 1"), CLIAUTH_ARGS_OPTION_COUNT);
+            return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+         }
+
+         payload->range = CLIAUTH_BOOLEAN_TRUE;
+         break;
+
+      case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_TOTP:
+         if (has_count == CLIAUTH_BOOLEAN_TRUE) {
+            cliauth_log(CLIAUTH_LOG_ERROR("%s can only be used with the HOTP algorithm"), CLIAUTH_ARGS_OPTION_COUNT);
+            return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+         }
+
+         if (has_from == CLIAUTH_BOOLEAN_FALSE && has_to == CLIAUTH_BOOLEAN_FALSE) {
+            break;
+         }
+
+         if (has_from == CLIAUTH_BOOLEAN_FALSE) {
+            time_from = payload->time_current;
+         }
+         if (has_to == CLIAUTH_BOOLEAN_FALSE) {
+            time_to = time_from;
+         }
+
+         /* the initial time is always 0 for now, so this can't fail yet.  it */
+         /* guards against a non-zero initial time, such as a T0 parameter */
+         /* in the key URI. */
+         if (time_from < payload->time_initial) {
+            cliauth_log(CLIAUTH_LOG_ERROR("%s must not be earlier than the initial time of the key"), CLIAUTH_ARGS_OPTION_FROM);
+            return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+         }
+
+         if (time_to < time_from) {
+            cliauth_log(CLIAUTH_LOG_ERROR("%s must not be earlier than %s"), CLIAUTH_ARGS_OPTION_TO, CLIAUTH_ARGS_OPTION_FROM);
+            return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+         }
+
+         payload->time_current = time_from;
+         payload->time_end = time_to;
+         payload->range = CLIAUTH_BOOLEAN_TRUE;
+         break;
+   }
+
+   return CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+}
+
 enum CliAuthArgsParseResult
 cliauth_args_parse(
    struct CliAuthArgsPayload * payload,
@@ -41,17 +163,80 @@ cliauth_args_parse(
    const char * key_uri;
    CliAuthUInt32 key_uri_characters;
    enum CliAuthParseKeyUriResult parse_key_uri_result;
+   enum CliAuthArgsParseResult result;
    const char * error_name;
+   CliAuthBoolean has_from, has_to, has_count, has_excess;
+   CliAuthUInt64 time_from, time_to;
+   CliAuthUInt16 index;
+
+   key_uri = CLIAUTH_NULLPTR;
+   has_from = CLIAUTH_BOOLEAN_FALSE;
+   has_to = CLIAUTH_BOOLEAN_FALSE;
+   has_count = CLIAUTH_BOOLEAN_FALSE;
+   has_excess = CLIAUTH_BOOLEAN_FALSE;
+   time_from = 0;
+   time_to = 0;
+   payload->count = 0;
+   payload->range = CLIAUTH_BOOLEAN_FALSE;
+   payload->import_path = CLIAUTH_NULLPTR;
+
+   index = 1;
+   while (index < args_count) {
+      if (strcmp(args[index], CLIAUTH_ARGS_OPTION_FROM) == 0) {
+         result = cliauth_args_parse_option_uint64(&time_from, args, args_count, index);
+         has_from = CLIAUTH_BOOLEAN_TRUE;
+         index++;
+      } else if (strcmp(args[index], CLIAUTH_ARGS_OPTION_TO) == 0) {
+         result = cliauth_args_parse_option_uint64(&time_to, args, args_count, index);
+         has_to = CLIAUTH_BOOLEAN_TRUE;
+         index++;
+      } else if (strcmp(args[index], CLIAUTH_ARGS_OPTION_COUNT) == 0) {
+         result = cliauth_args_parse_option_uint64(&payload->count, args, args_count, index);
+         has_count = CLIAUTH_BOOLEAN_TRUE;
+         index++;
+      } else if (strcmp(args[index], CLIAUTH_ARGS_OPTION_IMPORT) == 0) {
+         result = cliauth_args_parse_option_value(&payload->import_path, args, args_count, index);
+         index++;
+      } else if (key_uri == CLIAUTH_NULLPTR) {
+         key_uri = args[index];
+         result = CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+      } else {
+         has_excess = CLIAUTH_BOOLEAN_TRUE;
+         result = CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+      }
+
+      if (result != CLIAUTH_ARGS_PARSE_RESULT_SUCCESS) {
+         return result;
+      }
 
-   if (args_count < 2) {
+      index++;
+   }
+
+   payload->time_initial = 0;
+   payload->time_current = time(CLIAUTH_NULLPTR);
+   payload->time_end = payload->time_current;
+
+   if (payload->import_path != CLIAUTH_NULLPTR) {
+      if (key_uri != CLIAUTH_NULLPTR) {
+         cliauth_log(CLIAUTH_LOG_ERROR("a key URI can't be given together with %s"), CLIAUTH_ARGS_OPTION_IMPORT);
+         return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+      }
+      if (has_from == CLIAUTH_BOOLEAN_TRUE || has_to == CLIAUTH_BOOLEAN_TRUE || has_count == CLIAUTH_BOOLEAN_TRUE) {
+         cliauth_log(CLIAUTH_LOG_ERROR("%s can't be used together with %s, %s, or %s"), CLIAUTH_ARGS_OPTION_IMPORT, CLIAUTH_ARGS_OPTION_FROM, CLIAUTH_ARGS_OPTION_TO, CLIAUTH_ARGS_OPTION_COUNT);
+         return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
+      }
+
+      return CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+   }
+
+   if (key_uri == CLIAUTH_NULLPTR) {
       cliauth_log(CLIAUTH_LOG_ERROR("no key URI was given as an argument"));
       return CLIAUTH_ARGS_PARSE_RESULT_MISSING;
    }
-   if (args_count > 2) {
-      cliauth_log(CLIAUTH_LOG_WARNING("more than 1 argument was given, any excess arguments will be ignored"));
+   if (has_excess == CLIAUTH_BOOLEAN_TRUE) {
+      cliauth_log(CLIAUTH_LOG_WARNING("more than 1 key URI was given, any excess arguments will be ignored"));
    }
 
-   key_uri = args[1];
    key_uri_characters = strlen(key_uri);
 
    parse_key_uri_result = cliauth_parse_key_uri(
@@ -68,9 +253,13 @@ cliauth_args_parse(
       return CLIAUTH_ARGS_PARSE_RESULT_INVALID;
    }
 
-   payload->time_initial = 0;
-   payload->time_current = time(CLIAUTH_NULLPTR);
-
-   return CLIAUTH_ARGS_PARSE_RESULT_SUCCESS;
+   return cliauth_args_parse_range(
+      payload,
+      has_from,
+      has_to,
+      has_count,
+      time_from,
+      time_to
+   );
 }
 
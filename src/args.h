@@ -40,16 +40,57 @@ enum CliAuthArgsParseResult {
 /*                always be less than or equal to 'time_current'.             */
 /*                                                                            */
 /* time_current - The current time value for the TOTP algorithm.  This will   */
-/*                always be greater than or equal to 'time_initial'.          */
+/*                always be greater than or equal to 'time_initial'.  In      */
+/*                range mode, this is the start of the time range.            */
+/*                                                                            */
+/* time_end - The end of the time range for the TOTP algorithm in range mode, */
+/*            inclusive.  This will always be greater than or equal to        */
+/*            'time_current'.                                                 */
+/*                                                                            */
+/* count - The number of consecutive counters to generate passcodes for with  */
+/*         the HOTP algorithm in range mode.  This will always be at least 1. */
+/*                                                                            */
+/* range - Whether range mode was requested with '--from', '--to', or         */
+/*         '--count', in which case many passcodes are generated instead of   */
+/*         just one.                                                          */
+/*                                                                            */
+/* import_path - The null-terminated path of a file of key URIs given with    */
+/*               '--import', or CLIAUTH_NULLPTR if none was given.  When      */
+/*               present, 'uri' is not parsed and 'range' is always false.    */
 /*----------------------------------------------------------------------------*/
 struct CliAuthArgsPayload {
    struct CliAuthParseKeyUriPayload uri;
    CliAuthUInt64 time_initial;
    CliAuthUInt64 time_current;
+   CliAuthUInt64 time_end;
+   CliAuthUInt64 count;
+   CliAuthBoolean range;
+   const char * import_path;
 };
 
 /*----------------------------------------------------------------------------*/
-/* Parses command-line arguments using an array of string arguments.          */
+/* Human-readable descriptions of every cliauth_parse_key_uri() error, which  */
+/* are indexed by the error's enum value minus 1.                             */
+/*----------------------------------------------------------------------------*/
+extern const char * const
+cliauth_args_parse_key_uri_error_name [CLIAUTH_PARSE_KEY_URI_RESULT_FIELD_COUNT];
+
+/*----------------------------------------------------------------------------*/
+/* Parses command-line arguments using an array of string arguments.  The     */
+/* first argument which isn't an option is the key URI.  The following        */
+/* options are accepted, each followed by its value as a separate argument:   */
+/*                                                                            */
+/* --from <seconds> - Generate TOTP passcodes starting at this Unix time.     */
+/*                    Defaults to the current time.                           */
+/*                                                                            */
+/* --to <seconds> - Generate TOTP passcodes up to and including this Unix     */
+/*                  time.  Defaults to the value of '--from'.                 */
+/*                                                                            */
+/* --count <number> - Generate this many HOTP passcodes for consecutive       */
+/*                    counters, starting at the counter in the key URI.       */
+/*                                                                            */
+/* --import <path> - Generate the current passcode for every key URI in a     */
+/*                   file, one per line, instead of taking a single key URI.  */
 /*----------------------------------------------------------------------------*/
 /* payload - A pointer to a CliAuthArgsPayload struct where the final output  */
 /*          will be stored.  The data stored in this pointer will only be     */
@@ -7,95 +7,20 @@
 
 #include "cliauth.h"
 #include "args.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "cpu.h"
 #include "hash.h"
+#include "import.h"
+#include "mac.h"
 #include "otp.h"
+#include "pool.h"
 
 #define CLIAUTH_ABOUT PACKAGE_NAME " version " PACKAGE_VERSION
 
-union CliAuthOtpBuffersGenericHashContext {
-#if CLIAUTH_CONFIG_HASH_SHA1
-   struct CliAuthHashContextSha1 sha1;
-#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
-#if CLIAUTH_CONFIG_HASH_SHA224
-   struct CliAuthHashContextSha232 sha224;
-#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
-#if CLIAUTH_CONFIG_HASH_SHA256
-   struct CliAuthHashContextSha232 sha256;
-#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
-#if CLIAUTH_CONFIG_HASH_SHA384
-   struct CliAuthHashContextSha264 sha384;
-#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
-#if CLIAUTH_CONFIG_HASH_SHA512
-   struct CliAuthHashContextSha264 sha512;
-#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
-#if CLIAUTH_CONFIG_HASH_SHA512_224
-   struct CliAuthHashContextSha264 sha512_224;
-#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
-#if CLIAUTH_CONFIG_HASH_SHA512_256
-   struct CliAuthHashContextSha264 sha512_256;
-#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
-};
-
-union CliAuthOtpBuffersGenericDigest {
-#if CLIAUTH_CONFIG_HASH_SHA1
-   CliAuthUInt8 sha1 [CLIAUTH_HASH_SHA1_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
-#if CLIAUTH_CONFIG_HASH_SHA224
-   CliAuthUInt8 sha224 [CLIAUTH_HASH_SHA224_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
-#if CLIAUTH_CONFIG_HASH_SHA256
-   CliAuthUInt8 sha256 [CLIAUTH_HASH_SHA256_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
-#if CLIAUTH_CONFIG_HASH_SHA384
-   CliAuthUInt8 sha384 [CLIAUTH_HASH_SHA384_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
-#if CLIAUTH_CONFIG_HASH_SHA512
-   CliAuthUInt8 sha512 [CLIAUTH_HASH_SHA512_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
-#if CLIAUTH_CONFIG_HASH_SHA512_224
-   CliAuthUInt8 sha512_224 [CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
-#if CLIAUTH_CONFIG_HASH_SHA512_256
-   CliAuthUInt8 sha512_256 [CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
-};
-
-union CliAuthOtpBuffersGenericKey {
-#if CLIAUTH_CONFIG_HASH_SHA1
-   CliAuthUInt8 sha1 [CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
-#if CLIAUTH_CONFIG_HASH_SHA224
-   CliAuthUInt8 sha224 [CLIAUTH_HASH_SHA224_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
-#if CLIAUTH_CONFIG_HASH_SHA256
-   CliAuthUInt8 sha256 [CLIAUTH_HASH_SHA256_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
-#if CLIAUTH_CONFIG_HASH_SHA384
-   CliAuthUInt8 sha384 [CLIAUTH_HASH_SHA384_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
-#if CLIAUTH_CONFIG_HASH_SHA512
-   CliAuthUInt8 sha512 [CLIAUTH_HASH_SHA512_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
-#if CLIAUTH_CONFIG_HASH_SHA512_224
-   CliAuthUInt8 sha512_224 [CLIAUTH_HASH_SHA512_224_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
-#if CLIAUTH_CONFIG_HASH_SHA512_256
-   CliAuthUInt8 sha512_256 [CLIAUTH_HASH_SHA512_256_INPUT_BLOCK_LENGTH];
-#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
-};
-
-/* generic buffers large enough to run every possible hash algorithm. */
-/* this union trick allows us to figure out our stack layout/memory usage at */
-/* compile time with a runtime-chosen hash function without relying on either */
-/* guessing properly sized buffers or using too much preprocessor slop. */
-struct CliAuthOtpBuffersGeneric {
-   union CliAuthOtpBuffersGenericHashContext hash_context;
-   union CliAuthOtpBuffersGenericDigest digest_buffer;
-   union CliAuthOtpBuffersGenericKey key_buffer;
-};
-
 /* Return status enum for cliauth_main(). */
-#define CLIAUTH_EXIT_STATUS_FIELD_COUNT 3
+#define CLIAUTH_EXIT_STATUS_FIELD_COUNT 4
 enum CliAuthExitStatus {
    /* The program executed successfully without any errors. */
    CLIAUTH_EXIT_STATUS_SUCCESS = 0,
@@ -104,9 +29,27 @@ enum CliAuthExitStatus {
    CLIAUTH_EXIT_STATUS_MAXIMUM_ARGUMENTS_EXCEEDED = 1,
 
    /* There was an error parsing the arguments. */
-   CLIAUTH_EXIT_STATUS_ARGS_PARSE_ERROR = 2
+   CLIAUTH_EXIT_STATUS_ARGS_PARSE_ERROR = 2,
+
+   /* The file of key URIs to import couldn't be read. */
+   CLIAUTH_EXIT_STATUS_IMPORT_ERROR = 3
 };
 
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+/* shared by every mode which runs on a pool, since only one ever runs */
+static struct CliAuthPoolWorker cliauth_workers [CLIAUTH_POOL_WORKERS_MAX];
+
+/* the number of import chunks for every worker, which leaves room for */
+/* workers to steal from each other when some lines are slower to parse. */
+/* chunks are large, so they're allocated for the workers actually online */
+/* instead of for CLIAUTH_POOL_WORKERS_MAX. */
+#define CLIAUTH_IMPORT_CHUNKS_PER_WORKER 2
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
 static CliAuthUInt32
 cliauth_execute_hotp(
    const struct CliAuthArgsPayload * args,
@@ -165,6 +108,469 @@ cliauth_execute_totp(
    return passcode;
 }
 
+/* the longest line printed in range mode, which is a 20 digit label, a */
+/* space, a passcode of up to 9 digits, and a newline */
+#define CLIAUTH_RANGE_LINE_MAX 31
+
+/* writes the decimal digits of 'value', padded with zeroes to at least */
+/* 'width' digits, and returns the number of digits written */
+static CliAuthUInt8
+cliauth_format_decimal(
+   char output [],
+   CliAuthUInt64 value,
+   CliAuthUInt8 width
+) {
+   char digits [20];
+   CliAuthUInt8 count, written;
+
+   count = 0;
+   do {
+      digits[count] = (char)('0' + (value % 10));
+      value /= 10;
+      count++;
+   } while (value != 0);
+
+   while (count < width) {
+      digits[count] = '0';
+      count++;
+   }
+
+   written = 0;
+   while (count != 0) {
+      count--;
+      output[written] = digits[count];
+      written++;
+   }
+
+   return written;
+}
+
+/* the number of passcodes generated before they are printed */
+#define CLIAUTH_RANGE_BLOCK 4096
+
+/* the number of passcodes handed to a pool worker at once */
+#define CLIAUTH_RANGE_CHUNK 64
+
+struct CliAuthRangeBlock {
+   const struct CliAuthMacHmacKey * hmac_key;
+   CliAuthUInt32 * passcodes;
+   CliAuthUInt64 counter_first;
+   CliAuthUInt8 digits;
+};
+
+/* generates the passcodes for part of a block, using one buffer per lane */
+static void
+cliauth_range_generate(
+   void * block_generic,
+   struct CliAuthOtpBuffersGeneric buffers [],
+   CliAuthUInt64 index_first,
+   CliAuthUInt64 index_count
+) {
+   const struct CliAuthRangeBlock * block;
+   void * hash_context_pointers [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 counters [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 index_last;
+   CliAuthUInt32 lanes, lane;
+
+   block = (const struct CliAuthRangeBlock *)block_generic;
+
+   lane = 0;
+   while (lane != CLIAUTH_HASH_LANES_MAX) {
+      hash_context_pointers[lane] = &buffers[lane].hash_context;
+      lane++;
+   }
+
+   index_last = index_first + index_count;
+   while (index_first != index_last) {
+      lanes = CLIAUTH_HASH_LANES_MAX;
+      if (index_last - index_first < lanes) {
+         lanes = (CliAuthUInt32)(index_last - index_first);
+      }
+
+      lane = 0;
+      while (lane != lanes) {
+         counters[lane] = block->counter_first + index_first + lane;
+         lane++;
+      }
+
+      cliauth_otp_hotp_multi(
+         block->hmac_key,
+         hash_context_pointers,
+         &block->passcodes[index_first],
+         counters,
+         lanes,
+         block->digits
+      );
+
+      index_first += lanes;
+   }
+
+   return;
+}
+
+/* prints one line for each passcode of a block.  each line is labeled with */
+/* the counter, or with the step's start time when 'period' isn't zero */
+static void
+cliauth_range_print(
+   const struct CliAuthArgsPayload * args,
+   const struct CliAuthRangeBlock * block,
+   CliAuthUInt32 count,
+   CliAuthUInt64 period
+) {
+   char line [CLIAUTH_RANGE_LINE_MAX];
+   CliAuthUInt64 counter, label;
+   CliAuthUInt32 i;
+   CliAuthUInt8 line_characters;
+
+   i = 0;
+   while (i != count) {
+      counter = block->counter_first + i;
+
+      if (period == 0) {
+         label = counter;
+      } else {
+         label = args->time_initial + (counter * period);
+      }
+
+      line_characters = cliauth_format_decimal(line, label, 0);
+      line[line_characters] = ' ';
+      line_characters++;
+      line_characters += cliauth_format_decimal(
+         &line[line_characters],
+         block->passcodes[i],
+         block->digits
+      );
+      line[line_characters] = '\n';
+      line_characters++;
+
+      (void)fwrite(line, 1, line_characters, stdout);
+      i++;
+   }
+
+   return;
+}
+
+/* generates the passcodes of 'count' consecutive counters with the key pads */
+/* prepared once, streaming one line per passcode to stdout.  when threads */
+/* are enabled, each block of passcodes is split across a pool of workers. */
+static void
+cliauth_execute_range(
+   const struct CliAuthArgsPayload * args,
+   struct CliAuthOtpBuffersGeneric * buffers,
+   CliAuthUInt64 counter_first,
+   CliAuthUInt64 count,
+   CliAuthUInt64 period
+) {
+#if CLIAUTH_CONFIG_THREADS
+   struct CliAuthPool pool;
+#endif /* CLIAUTH_CONFIG_THREADS */
+   struct CliAuthOtpBuffersGeneric lane_buffers [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt32 passcodes [CLIAUTH_RANGE_BLOCK];
+   struct CliAuthMacHmacKey hmac_key;
+   struct CliAuthRangeBlock block;
+   CliAuthUInt64 offset;
+   CliAuthUInt32 block_count;
+   CliAuthBoolean pooled;
+
+   cliauth_mac_hmac_key_initialize(
+      &hmac_key,
+      args->uri.hash->function,
+      &buffers->hash_context,
+      &args->uri.secrets,
+      &buffers->key_buffer,
+      args->uri.secrets_bytes,
+      args->uri.hash->block_bytes,
+      args->uri.hash->digest_bytes
+   );
+
+   block.hmac_key = &hmac_key;
+   block.passcodes = passcodes;
+   block.digits = args->uri.digits;
+
+   pooled = CLIAUTH_BOOLEAN_FALSE;
+#if CLIAUTH_CONFIG_THREADS
+   if (count > CLIAUTH_RANGE_CHUNK) {
+      pooled = cliauth_pool_initialize(
+         &pool,
+         cliauth_workers,
+         cliauth_pool_workers_online()
+      );
+
+      if (pooled == CLIAUTH_BOOLEAN_FALSE) {
+         cliauth_log(CLIAUTH_LOG_WARNING("failed to start worker threads, generating passcodes on a single thread"));
+      }
+   }
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   offset = 0;
+   while (offset != count) {
+      block_count = CLIAUTH_RANGE_BLOCK;
+      if (count - offset < block_count) {
+         block_count = (CliAuthUInt32)(count - offset);
+      }
+
+      block.counter_first = counter_first + offset;
+
+#if CLIAUTH_CONFIG_THREADS
+      if (pooled == CLIAUTH_BOOLEAN_TRUE) {
+         cliauth_pool_run(
+            &pool,
+            cliauth_range_generate,
+            &block,
+            block_count,
+            CLIAUTH_RANGE_CHUNK
+         );
+      }
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+      if (pooled == CLIAUTH_BOOLEAN_FALSE) {
+         cliauth_range_generate(&block, lane_buffers, 0, block_count);
+      }
+
+      cliauth_range_print(args, &block, block_count, period);
+
+      offset += block_count;
+   }
+
+#if CLIAUTH_CONFIG_THREADS
+   if (pooled == CLIAUTH_BOOLEAN_TRUE) {
+      cliauth_pool_destroy(&pool);
+   }
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   (void)fflush(stdout);
+   return;
+}
+
+static void
+cliauth_execute_hotp_range(
+   const struct CliAuthArgsPayload * args,
+   struct CliAuthOtpBuffersGeneric * buffers
+) {
+   cliauth_log(CLIAUTH_LOG_INFO("initial counter value: %llu"), args->uri.algorithm_parameters.hotp.counter);
+   cliauth_log(CLIAUTH_LOG_INFO("passcode count: %llu"), args->count);
+
+   cliauth_log(CLIAUTH_LOG_INFO("generating passcodes using the HOTP algorithm"));
+
+   cliauth_execute_range(
+      args,
+      buffers,
+      args->uri.algorithm_parameters.hotp.counter,
+      args->count,
+      0
+   );
+
+   return;
+}
+
+static void
+cliauth_execute_totp_range(
+   const struct CliAuthArgsPayload * args,
+   struct CliAuthOtpBuffersGeneric * buffers
+) {
+   CliAuthUInt64 period;
+   CliAuthUInt64 counter_first, counter_last;
+
+   period = args->uri.algorithm_parameters.totp.period;
+
+   cliauth_log(CLIAUTH_LOG_INFO("initial time: %llu seconds"), args->time_initial);
+   cliauth_log(CLIAUTH_LOG_INFO("time range: %llu to %llu seconds"), args->time_current, args->time_end);
+   cliauth_log(CLIAUTH_LOG_INFO("period: %llu seconds"), period);
+
+   cliauth_log(CLIAUTH_LOG_INFO("generating passcodes using the TOTP algorithm"));
+
+   counter_first = (args->time_current - args->time_initial) / period;
+   counter_last = (args->time_end - args->time_initial) / period;
+
+   cliauth_execute_range(
+      args,
+      buffers,
+      counter_first,
+      counter_last - counter_first + 1,
+      period
+   );
+
+   return;
+}
+
+struct CliAuthImportState {
+   const struct CliAuthArgsPayload * args;
+   struct CliAuthOtpBuffersGeneric * buffers;
+   CliAuthUInt64 accounts;
+   CliAuthUInt64 failures;
+};
+
+/* prints the current passcode of an imported account, or reports the line */
+/* if its key URI couldn't be parsed */
+static void
+cliauth_import_account(
+   void * state_generic,
+   const struct CliAuthParseKeyUriPayload * payload,
+   enum CliAuthParseKeyUriResult result,
+   CliAuthUInt64 line
+) {
+   struct CliAuthImportState * state;
+   CliAuthUInt32 passcode;
+
+   state = (struct CliAuthImportState *)state_generic;
+
+   if (result != CLIAUTH_PARSE_KEY_URI_RESULT_SUCCESS) {
+      cliauth_log(CLIAUTH_LOG_WARNING("line %llu: failed to parse key URI: %s"), line, cliauth_args_parse_key_uri_error_name[result - 1]);
+      state->failures++;
+      return;
+   }
+
+   switch (payload->algorithm) {
+      case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_HOTP:
+         passcode = cliauth_otp_hotp(
+            payload->hash->function,
+            &state->buffers->hash_context,
+            &payload->secrets,
+            &state->buffers->digest_buffer,
+            &state->buffers->key_buffer,
+            payload->secrets_bytes,
+            payload->hash->block_bytes,
+            payload->hash->digest_bytes,
+            payload->algorithm_parameters.hotp.counter,
+            payload->digits
+         );
+         break;
+
+      case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_TOTP:
+      default:
+         passcode = cliauth_otp_totp(
+            payload->hash->function,
+            &state->buffers->hash_context,
+            &payload->secrets,
+            &state->buffers->digest_buffer,
+            &state->buffers->key_buffer,
+            payload->secrets_bytes,
+            payload->hash->block_bytes,
+            payload->hash->digest_bytes,
+            state->args->time_initial,
+            state->args->time_current,
+            payload->algorithm_parameters.totp.period,
+            payload->digits
+         );
+         break;
+   }
+
+   if (payload->issuer_characters != 0) {
+      (void)printf(
+         "%0*lu %.*s:%.*s\n",
+         (int)payload->digits,
+         (unsigned long)passcode,
+         (int)payload->issuer_characters,
+         payload->issuer,
+         (int)payload->account_name_characters,
+         payload->account_name
+      );
+   } else {
+      (void)printf(
+         "%0*lu %.*s\n",
+         (int)payload->digits,
+         (unsigned long)passcode,
+         (int)payload->account_name_characters,
+         payload->account_name
+      );
+   }
+
+   state->accounts++;
+   return;
+}
+
+static enum CliAuthExitStatus
+cliauth_execute_import(
+   const struct CliAuthArgsPayload * args,
+   struct CliAuthOtpBuffersGeneric * buffers
+) {
+#if CLIAUTH_CONFIG_THREADS
+   struct CliAuthPool pool;
+   struct CliAuthImportWorkers workers;
+   CliAuthUInt32 workers_count;
+   CliAuthBoolean pooled;
+#endif /* CLIAUTH_CONFIG_THREADS */
+   struct CliAuthImportState state;
+   enum CliAuthImportResult result;
+
+   cliauth_log(CLIAUTH_LOG_INFO("importing key URIs from %s"), args->import_path);
+
+   state.args = args;
+   state.buffers = buffers;
+   state.accounts = 0;
+   state.failures = 0;
+
+#if CLIAUTH_CONFIG_THREADS
+   workers_count = cliauth_pool_workers_online();
+
+   workers.pool = &pool;
+   workers.chunks_count = workers_count * CLIAUTH_IMPORT_CHUNKS_PER_WORKER;
+   workers.chunks = (struct CliAuthImportChunk *)malloc(
+      (size_t)workers.chunks_count * sizeof(struct CliAuthImportChunk)
+   );
+
+   pooled = CLIAUTH_BOOLEAN_FALSE;
+   if (workers.chunks == CLIAUTH_NULLPTR) {
+      cliauth_log(CLIAUTH_LOG_WARNING("failed to allocate import chunks, importing on a single thread"));
+   } else {
+      pooled = cliauth_pool_initialize(
+         &pool,
+         cliauth_workers,
+         workers_count
+      );
+
+      if (pooled == CLIAUTH_BOOLEAN_FALSE) {
+         cliauth_log(CLIAUTH_LOG_WARNING("failed to start worker threads, importing on a single thread"));
+      }
+   }
+
+   if (pooled == CLIAUTH_BOOLEAN_TRUE) {
+      result = cliauth_import_file_parallel(
+         &workers,
+         args->import_path,
+         cliauth_import_account,
+         &state
+      );
+
+      cliauth_pool_destroy(&pool);
+   } else {
+      result = cliauth_import_file(
+         args->import_path,
+         cliauth_import_account,
+         &state
+      );
+   }
+
+   free(workers.chunks);
+#else /* CLIAUTH_CONFIG_THREADS */
+   result = cliauth_import_file(
+      args->import_path,
+      cliauth_import_account,
+      &state
+   );
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   switch (result) {
+      case CLIAUTH_IMPORT_RESULT_SUCCESS:
+         break;
+
+      case CLIAUTH_IMPORT_RESULT_OPEN_FAILED:
+         cliauth_log(CLIAUTH_LOG_ERROR("failed to open %s"), args->import_path);
+         return CLIAUTH_EXIT_STATUS_IMPORT_ERROR;
+
+      case CLIAUTH_IMPORT_RESULT_READ_FAILED:
+         (void)fflush(stdout);
+         cliauth_log(CLIAUTH_LOG_ERROR("failed to read %s"), args->import_path);
+         return CLIAUTH_EXIT_STATUS_IMPORT_ERROR;
+   }
+
+   (void)fflush(stdout);
+
+   cliauth_log(CLIAUTH_LOG_INFO("imported %llu accounts, %llu lines failed to parse"), state.accounts, state.failures);
+
+   return CLIAUTH_EXIT_STATUS_SUCCESS;
+}
+
 static enum CliAuthExitStatus
 cliauth_main(CliAuthUInt16 argc, const char * const argv []) {
    struct CliAuthArgsPayload args;
@@ -173,6 +579,9 @@ cliauth_main(CliAuthUInt16 argc, const char * const argv []) {
 
    cliauth_log(CLIAUTH_LOG_INFO(CLIAUTH_ABOUT));
 
+   cliauth_cpu_initialize();
+   cliauth_hash_initialize();
+
    switch (cliauth_args_parse(&args, argv, argc)) {
       case CLIAUTH_ARGS_PARSE_RESULT_SUCCESS:
          break;
@@ -182,9 +591,27 @@ cliauth_main(CliAuthUInt16 argc, const char * const argv []) {
          return CLIAUTH_EXIT_STATUS_ARGS_PARSE_ERROR;
    }
 
+   if (args.import_path != CLIAUTH_NULLPTR) {
+      return cliauth_execute_import(&args, &buffers);
+   }
+
    cliauth_log(CLIAUTH_LOG_INFO("issuer: %.*s"), args.uri.issuer_characters, &args.uri.issuer);
    cliauth_log(CLIAUTH_LOG_INFO("account name: %.*s"), args.uri.account_name_characters, &args.uri.account_name);
 
+   if (args.range == CLIAUTH_BOOLEAN_TRUE) {
+      switch (args.uri.algorithm) {
+         case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_HOTP:
+            cliauth_execute_hotp_range(&args, &buffers);
+            break;
+
+         case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_TOTP:
+            cliauth_execute_totp_range(&args, &buffers);
+            break;
+      }
+
+      return CLIAUTH_EXIT_STATUS_SUCCESS;
+   }
+
    switch (args.uri.algorithm) {
       case CLIAUTH_PARSE_KEY_URI_PAYLOAD_ALGORITHM_HOTP:
          passcode = cliauth_execute_hotp(&args, &buffers);
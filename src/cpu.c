@@ -0,0 +1,108 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/cpu.c - Runtime CPU feature detection implementation.                  */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "cpu.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+#include <cpuid.h>
+
+/* cpuid leaf 1, register ecx */
+#define CLIAUTH_CPU_X86_CPUID_1_ECX_SSSE3    ((CliAuthUInt32)1 << 9)
+#define CLIAUTH_CPU_X86_CPUID_1_ECX_SSE41    ((CliAuthUInt32)1 << 19)
+#define CLIAUTH_CPU_X86_CPUID_1_ECX_OSXSAVE  ((CliAuthUInt32)1 << 27)
+#define CLIAUTH_CPU_X86_CPUID_1_ECX_AVX      ((CliAuthUInt32)1 << 28)
+
+/* cpuid leaf 1, register edx */
+#define CLIAUTH_CPU_X86_CPUID_1_EDX_SSE2     ((CliAuthUInt32)1 << 26)
+
+/* cpuid leaf 7 subleaf 0, register ebx */
+#define CLIAUTH_CPU_X86_CPUID_7_EBX_AVX2     ((CliAuthUInt32)1 << 5)
+#define CLIAUTH_CPU_X86_CPUID_7_EBX_SHA      ((CliAuthUInt32)1 << 29)
+
+/* XCR0 bits which must be set for the OS to preserve the XMM and YMM state */
+#define CLIAUTH_CPU_X86_XCR0_XMM_YMM         ((CliAuthUInt32)0x6)
+
+static CliAuthUInt32
+cliauth_cpu_x86_features_detected = 0;
+
+static CliAuthUInt32
+cliauth_cpu_x86_xgetbv_low(void) {
+   CliAuthUInt32 low, high;
+
+   __asm__ __volatile__ ("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+   (void)high;
+
+   return low;
+}
+
+static CliAuthUInt32
+cliauth_cpu_x86_detect(void) {
+   unsigned int eax, ebx, ecx, edx;
+   CliAuthUInt32 features;
+   CliAuthBoolean os_avx;
+
+   features = 0;
+   os_avx = CLIAUTH_BOOLEAN_FALSE;
+
+   if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+      return features;
+   }
+
+   if ((edx & CLIAUTH_CPU_X86_CPUID_1_EDX_SSE2) != 0) {
+      features |= CLIAUTH_CPU_X86_FEATURE_SSE2;
+   }
+   if ((ecx & CLIAUTH_CPU_X86_CPUID_1_ECX_SSSE3) != 0) {
+      features |= CLIAUTH_CPU_X86_FEATURE_SSSE3;
+   }
+   if ((ecx & CLIAUTH_CPU_X86_CPUID_1_ECX_SSE41) != 0) {
+      features |= CLIAUTH_CPU_X86_FEATURE_SSE41;
+   }
+
+   /* the YMM registers are only usable if the OS saves them on a context */
+   /* switch, which has to be checked through XCR0 */
+   if (
+      (ecx & CLIAUTH_CPU_X86_CPUID_1_ECX_OSXSAVE) != 0 &&
+      (ecx & CLIAUTH_CPU_X86_CPUID_1_ECX_AVX) != 0 &&
+      (cliauth_cpu_x86_xgetbv_low() & CLIAUTH_CPU_X86_XCR0_XMM_YMM) == CLIAUTH_CPU_X86_XCR0_XMM_YMM
+   ) {
+      os_avx = CLIAUTH_BOOLEAN_TRUE;
+   }
+
+   if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+      return features;
+   }
+
+   if ((ebx & CLIAUTH_CPU_X86_CPUID_7_EBX_AVX2) != 0 && os_avx == CLIAUTH_BOOLEAN_TRUE) {
+      features |= CLIAUTH_CPU_X86_FEATURE_AVX2;
+   }
+   if ((ebx & CLIAUTH_CPU_X86_CPUID_7_EBX_SHA) != 0) {
+      features |= CLIAUTH_CPU_X86_FEATURE_SHA;
+   }
+
+   return features;
+}
+
+CliAuthUInt32
+cliauth_cpu_x86_features(void) {
+   return cliauth_cpu_x86_features_detected;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+void
+cliauth_cpu_initialize(void) {
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+   cliauth_cpu_x86_features_detected = cliauth_cpu_x86_detect();
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+   return;
+}
+
@@ -0,0 +1,67 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/cpu.h - Runtime CPU feature detection header.                          */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_CPU_H
+#define _CLIAUTH_CPU_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+#if !defined(__x86_64__) && !defined(__i386__)
+#error x86 extensions are enabled, but the target platform is not x86.  please verify the build was configured correctly.
+#endif
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/*----------------------------------------------------------------------------*/
+/* Detects the features supported by the host CPU and caches them for later   */
+/* queries.  This should be called once at startup before any other threads   */
+/* are created.  Until this is called, no optional CPU features will be       */
+/* reported as supported.                                                     */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_cpu_initialize(void);
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* Bit flags for x86 instruction set extensions.                              */
+/*----------------------------------------------------------------------------*/
+/* CLIAUTH_CPU_X86_FEATURE_SSE2 - SSE2 instructions.                          */
+/*                                                                            */
+/* CLIAUTH_CPU_X86_FEATURE_SSSE3 - Supplemental SSE3 instructions.            */
+/*                                                                            */
+/* CLIAUTH_CPU_X86_FEATURE_SSE41 - SSE4.1 instructions.                       */
+/*                                                                            */
+/* CLIAUTH_CPU_X86_FEATURE_AVX2 - AVX2 instructions, including operating      */
+/*                                system support for saving the YMM           */
+/*                                registers.                                  */
+/*                                                                            */
+/* CLIAUTH_CPU_X86_FEATURE_SHA - SHA extensions for SHA-1 and SHA-256.        */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_CPU_X86_FEATURE_SSE2   ((CliAuthUInt32)(1 << 0))
+#define CLIAUTH_CPU_X86_FEATURE_SSSE3  ((CliAuthUInt32)(1 << 1))
+#define CLIAUTH_CPU_X86_FEATURE_SSE41  ((CliAuthUInt32)(1 << 2))
+#define CLIAUTH_CPU_X86_FEATURE_AVX2   ((CliAuthUInt32)(1 << 3))
+#define CLIAUTH_CPU_X86_FEATURE_SHA    ((CliAuthUInt32)(1 << 4))
+
+/*----------------------------------------------------------------------------*/
+/* Queries the x86 instruction set extensions detected by                     */
+/* cliauth_cpu_initialize().                                                  */
+/*----------------------------------------------------------------------------*/
+/* Return value - A bitwise OR of CLIAUTH_CPU_X86_FEATURE_* flags.            */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt32
+cliauth_cpu_x86_features(void);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_CPU_H */
+
@@ -11,6 +11,17 @@
 #include <string.h>
 #include "endian.h"
 #include "bitwise.h"
+#include "cpu.h"
+#include "hash_x86.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/* CPU features required by the single-block SHA extension implementations */
+#define _CLIAUTH_HASH_X86_FEATURES_SHA (\
+   CLIAUTH_CPU_X86_FEATURE_SHA |\
+   CLIAUTH_CPU_X86_FEATURE_SSSE3 |\
+   CLIAUTH_CPU_X86_FEATURE_SSE41\
+)
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
 
 #if _CLIAUTH_HASH_SHA1_2
 /*----------------------------------------------------------------------------*/
@@ -28,6 +39,21 @@ struct CliAuthHashSha12RingBufferImplementation {
 
    /* the size of the ring buffer and each input block in bytes */
    CliAuthUInt32 bytes;
+
+   /* the size of the message length field appended when padding */
+   CliAuthUInt32 length_bytes;
+};
+
+/* the largest input block length of any SHA hash */
+#define _CLIAUTH_HASH_SHA1_2_BLOCK_LENGTH_MAX\
+   128
+
+/* template for the message padding, which is a single 1 bit followed by */
+/* zeroes.  the padding and the zeroed upper bytes of the length field are */
+/* copied from this in one step. */
+static const CliAuthUInt8
+cliauth_hash_sha1_2_padding [_CLIAUTH_HASH_SHA1_2_BLOCK_LENGTH_MAX] = {
+   (1 << 7)
 };
 
 /* initializes the state of the ring buffer */
@@ -42,6 +68,20 @@ cliauth_hash_sha1_2_ring_buffer_initialize(
    return;
 }
 
+/* initializes the state of the ring buffer as if 'total' bytes had already */
+/* been digested, which must be a multiple of the block length */
+static void
+cliauth_hash_sha1_2_ring_buffer_resume(
+   const struct CliAuthHashSha12RingBufferImplementation * implementation,
+   struct _CliAuthHashSha12RingBufferContext * context,
+   CliAuthUInt64 total
+) {
+   context->capacity = implementation->bytes;
+   context->total = total;
+
+   return;
+}
+
 /* loads a message into the ring buffer, digesting if the ring buffer fills */
 static void
 cliauth_hash_sha1_2_ring_buffer_digest(
@@ -96,7 +136,7 @@ cliauth_hash_sha1_2_ring_buffer_digest(
    while (digest_blocks != 0) {
       implementation->digest(state, message_iter);
 
-      message_iter += (digest_blocks * implementation->bytes);
+      message_iter += implementation->bytes;
       digest_blocks--;
    }
 
@@ -112,6 +152,26 @@ cliauth_hash_sha1_2_ring_buffer_digest(
    return;
 }
 
+/* writes the message length in bits to the end of a padded block.  the */
+/* upper bytes of length fields longer than 64 bits must already be zero. */
+static void
+cliauth_hash_sha1_2_ring_buffer_write_length(
+   const struct CliAuthHashSha12RingBufferImplementation * implementation,
+   CliAuthUInt8 * buffer,
+   CliAuthUInt64 total
+) {
+   CliAuthUInt64 message_length_bits_big_endian;
+
+   message_length_bits_big_endian = cliauth_endian_host_to_big_uint64(total * 8);
+   (void)memcpy(
+      buffer + implementation->bytes - sizeof(message_length_bits_big_endian),
+      &message_length_bits_big_endian,
+      sizeof(message_length_bits_big_endian)
+   );
+
+   return;
+}
+
 /* performs the SHA message padding step on remaining data and digests the */
 /* resulting padded message.  this also invalidates the state of the ring */
 /* buffer, which will require initialization to be used again. */
@@ -122,57 +182,216 @@ cliauth_hash_sha1_2_ring_buffer_finalize(
    void * state,
    CliAuthUInt8 * buffer
 ) {
-   CliAuthUInt8 * ring_buffer_iter;
-   CliAuthUInt8 zero_pad_bytes;
-   CliAuthUInt64 message_length_bits_big_endian;
+   CliAuthUInt8 * ring_buffer_free;
 
-   /* initialize iterator to the start of free space */
-   ring_buffer_iter = buffer + (implementation->bytes - context->capacity);
-
-   /* append the leading 1 bit.  this will always be valid since the ring */
-   /* buffer can never be in a full state */
-   *ring_buffer_iter = (1 << 7);
-   ring_buffer_iter += 1;
-
-   /* calculate the number of zeroes to pad with */
-   zero_pad_bytes = (
-      implementation->bytes
-      - 1
-      - sizeof(message_length_bits_big_endian)
-      + context->capacity
-   ) % implementation->bytes;
-
-   /* if the amount of pad bytes will require a new block, fill the ring */
-   /* buffer and digest with as many zeroes as will fit and then fill the */
-   /* next block with zeroes */
-   if (zero_pad_bytes > context->capacity - 1) {
-      (void)memset(ring_buffer_iter, 0x00, context->capacity - 1);
-      ring_buffer_iter = buffer;
-      zero_pad_bytes -= context->capacity - 1;
+   /* calculate a pointer to the start of free space in the ring buffer */
+   ring_buffer_free = buffer + (implementation->bytes - context->capacity);
 
+   /* if the padding and length field don't fit in the remaining space, */
+   /* pad out and digest the current block, then zero the next one up to */
+   /* the 64-bit length.  otherwise, copy the padding along with the zero */
+   /* upper bytes of the length field in one step.  since the ring buffer */
+   /* is never full, there is always room for at least the leading 1 bit. */
+   if (context->capacity <= implementation->length_bytes) {
+      (void)memcpy(
+         ring_buffer_free,
+         cliauth_hash_sha1_2_padding,
+         context->capacity
+      );
       implementation->digest(state, buffer);
+
+      (void)memset(buffer, 0x00, implementation->bytes - sizeof(CliAuthUInt64));
+   } else {
+      (void)memcpy(
+         ring_buffer_free,
+         cliauth_hash_sha1_2_padding,
+         context->capacity - sizeof(CliAuthUInt64)
+      );
+   }
+
+   /* append the message length and digest the final block */
+   cliauth_hash_sha1_2_ring_buffer_write_length(
+      implementation,
+      buffer,
+      context->total
+   );
+   implementation->digest(state, buffer);
+
+   return;
+}
+
+/* checks if a message can be digested and finalized as a single padded */
+/* block, which requires an empty ring buffer */
+static CliAuthBoolean
+cliauth_hash_sha1_2_ring_buffer_fits_single_block(
+   const struct CliAuthHashSha12RingBufferImplementation * implementation,
+   const struct _CliAuthHashSha12RingBufferContext * context,
+   CliAuthUInt32 message_bytes
+) {
+   if (context->capacity != implementation->bytes) {
+      return CLIAUTH_BOOLEAN_FALSE;
+   }
+   if (message_bytes >= implementation->bytes - implementation->length_bytes) {
+      return CLIAUTH_BOOLEAN_FALSE;
    }
 
-   /* write the remaining pad zeroes */
-   (void)memset(ring_buffer_iter, 0x00, zero_pad_bytes);
-   ring_buffer_iter += zero_pad_bytes;
+   return CLIAUTH_BOOLEAN_TRUE;
+}
 
-   /* calculate the message length in bits, convert to big endian, and append */
-   /* to the end of the message */
-   message_length_bits_big_endian = cliauth_endian_host_to_big_uint64(context->total * 8);
+/* builds the final padded block for a message which fits in a single block */
+/* directly from the padding template, without any of the general padding */
+/* logic */
+static void
+cliauth_hash_sha1_2_ring_buffer_pad_single_block(
+   const struct CliAuthHashSha12RingBufferImplementation * implementation,
+   const struct _CliAuthHashSha12RingBufferContext * context,
+   CliAuthUInt8 * buffer,
+   const void * message,
+   CliAuthUInt32 message_bytes
+) {
+   (void)memcpy(buffer, message, message_bytes);
    (void)memcpy(
-      ring_buffer_iter,
-      &message_length_bits_big_endian,
-      sizeof(message_length_bits_big_endian)
+      buffer + message_bytes,
+      cliauth_hash_sha1_2_padding,
+      implementation->bytes - sizeof(CliAuthUInt64) - message_bytes
    );
-   ring_buffer_iter += sizeof(message_length_bits_big_endian);
+   cliauth_hash_sha1_2_ring_buffer_write_length(
+      implementation,
+      buffer,
+      context->total + message_bytes
+   );
+
+   return;
+}
+
+/* digests the final part of a message and finalizes.  when the message fits */
+/* in a single padded block, it is built directly without going through the */
+/* ring buffer.  the message is read in full before the state is written, */
+/* so it may overlap the digest in the state. */
+static void
+cliauth_hash_sha1_2_ring_buffer_digest_finalize(
+   const struct CliAuthHashSha12RingBufferImplementation * implementation,
+   struct _CliAuthHashSha12RingBufferContext * context,
+   void * state,
+   CliAuthUInt8 * buffer,
+   const void * message,
+   CliAuthUInt32 message_bytes
+) {
+   if (cliauth_hash_sha1_2_ring_buffer_fits_single_block(
+      implementation,
+      context,
+      message_bytes
+   ) == CLIAUTH_BOOLEAN_FALSE) {
+      cliauth_hash_sha1_2_ring_buffer_digest(
+         implementation,
+         context,
+         state,
+         buffer,
+         message,
+         message_bytes
+      );
+      cliauth_hash_sha1_2_ring_buffer_finalize(
+         implementation,
+         context,
+         state,
+         buffer
+      );
+
+      return;
+   }
 
-   /* digest the final block */
+   cliauth_hash_sha1_2_ring_buffer_pad_single_block(
+      implementation,
+      context,
+      buffer,
+      message,
+      message_bytes
+   );
    implementation->digest(state, buffer);
 
    return;
 }
 
+/* digests and finalizes messages of the same length into up to */
+/* CLIAUTH_HASH_LANES_MAX contexts, compressing the final blocks together */
+/* with 'digest_block_multi'.  contexts which share both their message and */
+/* total length have identical final blocks, so the block is only built once */
+/* and shared between their lanes.  if any message doesn't fit in a single */
+/* padded block, each context is finalized separately instead. */
+static void
+cliauth_hash_sha1_2_ring_buffer_digest_finalize_multi(
+   const struct CliAuthHashSha12RingBufferImplementation * implementation,
+   CliAuthHashFunctionDigestBlockMulti digest_block_multi,
+   struct _CliAuthHashSha12RingBufferContext * const ring_contexts [],
+   CliAuthUInt8 * const buffers [],
+   void * const states [],
+   const void * const messages [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   const void * blocks [CLIAUTH_HASH_LANES_MAX];
+   CliAuthBoolean fits;
+   CliAuthUInt32 lane;
+
+   fits = CLIAUTH_BOOLEAN_TRUE;
+   lane = 0;
+   while (lane != count) {
+      if (cliauth_hash_sha1_2_ring_buffer_fits_single_block(
+         implementation,
+         ring_contexts[lane],
+         message_bytes
+      ) == CLIAUTH_BOOLEAN_FALSE) {
+         fits = CLIAUTH_BOOLEAN_FALSE;
+      }
+
+      lane++;
+   }
+
+   if (fits == CLIAUTH_BOOLEAN_FALSE) {
+      lane = 0;
+      while (lane != count) {
+         cliauth_hash_sha1_2_ring_buffer_digest_finalize(
+            implementation,
+            ring_contexts[lane],
+            states[lane],
+            buffers[lane],
+            messages[lane],
+            message_bytes
+         );
+
+         lane++;
+      }
+
+      return;
+   }
+
+   lane = 0;
+   while (lane != count) {
+      if (
+         lane != 0 &&
+         messages[lane] == messages[0] &&
+         ring_contexts[lane]->total == ring_contexts[0]->total
+      ) {
+         blocks[lane] = blocks[0];
+      } else {
+         cliauth_hash_sha1_2_ring_buffer_pad_single_block(
+            implementation,
+            ring_contexts[lane],
+            buffers[lane],
+            messages[lane],
+            message_bytes
+         );
+         blocks[lane] = buffers[lane];
+      }
+
+      lane++;
+   }
+
+   digest_block_multi(states, blocks, count);
+
+   return;
+}
+
 /* loads the initial part of the message schedule from the input block */
 static void
 cliauth_hash_sha1_2_load_message_block(
@@ -231,7 +450,15 @@ cliauth_hash_sha1_2_digest_endian_host_to_big(
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_HASH_SHA1_2 */
 
-#if _CLIAUTH_HASH_SHA1_2_32
+/* the unrolled SHA1 implementation inlines these, so they are only needed */
+/* by SHA2-32 and the compact SHA1 implementation */
+#define _CLIAUTH_HASH_SHA1_2_32_PORTABLE\
+   (\
+      _CLIAUTH_HASH_SHA2_32 ||\
+      (CLIAUTH_CONFIG_HASH_SHA1 && !CLIAUTH_CONFIG_HASH_SHA1_UNROLLED)\
+   )
+
+#if _CLIAUTH_HASH_SHA1_2_32_PORTABLE
 /*----------------------------------------------------------------------------*/
 
 static CliAuthUInt32
@@ -267,11 +494,119 @@ cliauth_hash_sha1_2_32_compute_intermediate_digest(
 }
 
 /*----------------------------------------------------------------------------*/
-#endif /* _CLIAUTH_HASH_SHA1_2_32 */
+#endif /* _CLIAUTH_HASH_SHA1_2_32_PORTABLE */
 
 #if CLIAUTH_CONFIG_HASH_SHA1
 /*----------------------------------------------------------------------------*/
 
+#if CLIAUTH_CONFIG_HASH_SHA1_UNROLLED
+/*----------------------------------------------------------------------------*/
+
+/* everything is expanded in-place so the compiler can keep the working */
+/* variables in registers and fold the round functions into each round */
+#define _CLIAUTH_HASH_SHA1_ROTATE_LEFT(x, bits)\
+   (((x) << (bits)) | ((x) >> (32 - (bits))))
+
+#define _CLIAUTH_HASH_SHA1_CH(x, y, z)\
+   ((z) ^ ((x) & ((y) ^ (z))))
+
+#define _CLIAUTH_HASH_SHA1_PARITY(x, y, z)\
+   ((x) ^ (y) ^ (z))
+
+#define _CLIAUTH_HASH_SHA1_MAJ(x, y, z)\
+   (((x) & (y)) | ((z) & ((x) | (y))))
+
+/* performs a single round.  instead of shifting the working variables, the */
+/* caller rotates which variables are passed as arguments. */
+#define _CLIAUTH_HASH_SHA1_ROUND(a, b, c, d, e, function, constant, word)\
+   e += _CLIAUTH_HASH_SHA1_ROTATE_LEFT(a, 5) + function(b, c, d) + (constant) + (word);\
+   b = _CLIAUTH_HASH_SHA1_ROTATE_LEFT(b, 30);
+
+/* retrieves the message schedule word for round 't'.  with a rolling */
+/* schedule, words past the first 16 are expanded here in the window. */
+#if CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+#define _CLIAUTH_HASH_SHA1_WORD(t)\
+   ((t) < 16 ? schedule[(t)] : (\
+      w = schedule[((t) - 3) & 15] ^ schedule[((t) - 8) & 15] ^ schedule[((t) - 14) & 15] ^ schedule[(t) & 15],\
+      schedule[(t) & 15] = _CLIAUTH_HASH_SHA1_ROTATE_LEFT(w, 1)\
+   ))
+#else /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+#define _CLIAUTH_HASH_SHA1_WORD(t)\
+   schedule[(t)]
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+
+/* performs five rounds starting at round 't', after which the working */
+/* variables are back in their original positions */
+#define _CLIAUTH_HASH_SHA1_ROUNDS_5(function, constant, t)\
+   _CLIAUTH_HASH_SHA1_ROUND(a, b, c, d, e, function, constant, _CLIAUTH_HASH_SHA1_WORD((t) + 0))\
+   _CLIAUTH_HASH_SHA1_ROUND(e, a, b, c, d, function, constant, _CLIAUTH_HASH_SHA1_WORD((t) + 1))\
+   _CLIAUTH_HASH_SHA1_ROUND(d, e, a, b, c, function, constant, _CLIAUTH_HASH_SHA1_WORD((t) + 2))\
+   _CLIAUTH_HASH_SHA1_ROUND(c, d, e, a, b, function, constant, _CLIAUTH_HASH_SHA1_WORD((t) + 3))\
+   _CLIAUTH_HASH_SHA1_ROUND(b, c, d, e, a, function, constant, _CLIAUTH_HASH_SHA1_WORD((t) + 4))
+
+#define _CLIAUTH_HASH_SHA1_ROUNDS_20(function, constant, t)\
+   _CLIAUTH_HASH_SHA1_ROUNDS_5(function, constant, (t) + 0)\
+   _CLIAUTH_HASH_SHA1_ROUNDS_5(function, constant, (t) + 5)\
+   _CLIAUTH_HASH_SHA1_ROUNDS_5(function, constant, (t) + 10)\
+   _CLIAUTH_HASH_SHA1_ROUNDS_5(function, constant, (t) + 15)
+
+static void
+cliauth_hash_sha1_digest_block(
+   void * context,
+   const void * block
+) {
+   struct CliAuthHashContextSha1 * context_sha;
+   CliAuthUInt32 * schedule;
+   CliAuthUInt32 a, b, c, d, e, w;
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+   CliAuthUInt8 t;
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+
+   context_sha = (struct CliAuthHashContextSha1 *)context;
+   schedule = context_sha->schedule;
+
+   /* 0 <= t <= 15 */
+   cliauth_hash_sha1_2_load_message_block(
+      (const CliAuthUInt8 *)block,
+      schedule,
+      _CLIAUTH_HASH_SHA1_BLOCK_LENGTH,
+      sizeof(CliAuthUInt32)
+   );
+
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+   /* 16 <= t <= 79 */
+   t = 16;
+   while (t != _CLIAUTH_HASH_SHA1_ROUNDS_COUNT) {
+      w = schedule[t - 3] ^ schedule[t - 8] ^ schedule[t - 14] ^ schedule[t - 16];
+      schedule[t] = _CLIAUTH_HASH_SHA1_ROTATE_LEFT(w, 1);
+      t++;
+   }
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+
+   a = context_sha->digest[0];
+   b = context_sha->digest[1];
+   c = context_sha->digest[2];
+   d = context_sha->digest[3];
+   e = context_sha->digest[4];
+
+   _CLIAUTH_HASH_SHA1_ROUNDS_20(_CLIAUTH_HASH_SHA1_CH, 0x5a827999, 0)
+   _CLIAUTH_HASH_SHA1_ROUNDS_20(_CLIAUTH_HASH_SHA1_PARITY, 0x6ed9eba1, 20)
+   _CLIAUTH_HASH_SHA1_ROUNDS_20(_CLIAUTH_HASH_SHA1_MAJ, 0x8f1bbcdc, 40)
+   _CLIAUTH_HASH_SHA1_ROUNDS_20(_CLIAUTH_HASH_SHA1_PARITY, 0xca62c1d6, 60)
+
+   context_sha->digest[0] += a;
+   context_sha->digest[1] += b;
+   context_sha->digest[2] += c;
+   context_sha->digest[3] += d;
+   context_sha->digest[4] += e;
+
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#else /* CLIAUTH_CONFIG_HASH_SHA1_UNROLLED */
+/*----------------------------------------------------------------------------*/
+
 typedef CliAuthUInt32 (*CliAuthHashSha1Function)(CliAuthUInt32 x, CliAuthUInt32 y, CliAuthUInt32 z);
 
 static const CliAuthHashSha1Function
@@ -296,8 +631,10 @@ cliauth_hash_sha1_create_message_schedule(
    CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA1_MESSAGE_SCHEDULE_LENGTH]
 ) {
    CliAuthUInt32 * schedule_iter;
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
    CliAuthUInt32 a, b, c, d, e;
    CliAuthUInt8 t;
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
 
    schedule_iter = schedule;
 
@@ -308,6 +645,7 @@ cliauth_hash_sha1_create_message_schedule(
       _CLIAUTH_HASH_SHA1_BLOCK_LENGTH,
       sizeof(CliAuthUInt32)
    );
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
    schedule_iter += _CLIAUTH_HASH_SHA1_BLOCK_LENGTH / sizeof(CliAuthUInt32);
 
    /* 16 <= t <= 79 */
@@ -324,26 +662,47 @@ cliauth_hash_sha1_create_message_schedule(
       schedule_iter++;
       t--;
    }
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
 
    return;
 }
 
+/* retrieves the message schedule word for round 't'.  with a rolling */
+/* schedule, words past the first 16 are expanded in-place within the */
+/* 16-word window, so this must be called for each round in order. */
+static CliAuthUInt32
+cliauth_hash_sha1_message_schedule_word(
+   CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA1_MESSAGE_SCHEDULE_LENGTH],
+   CliAuthUInt8 t
+) {
+#if CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+   if (t >= 16) {
+      CliAuthUInt32 w;
+
+      w = schedule[(t - 3) & 15] ^ schedule[(t - 8) & 15] ^ schedule[(t - 14) & 15] ^ schedule[t & 15];
+      schedule[t & 15] = cliauth_bitwise_rotate_left_uint32(w, 1);
+   }
+
+   return schedule[t & 15];
+#else /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+   return schedule[t];
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+}
+
 static void
 cliauth_hash_sha1_perform_rounds_and_additions(
    CliAuthUInt32 work [_CLIAUTH_HASH_SHA1_DIGEST_WORDS_COUNT],
-   const CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA1_MESSAGE_SCHEDULE_LENGTH]
+   CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA1_MESSAGE_SCHEDULE_LENGTH]
 ) {
    CliAuthUInt8 t, i, j;
    CliAuthUInt32 a, b, c, d, e;
    CliAuthUInt32 t1;
-   const CliAuthUInt32 * schedule_iter;
    const CliAuthHashSha1Function * constants_function_iter;
    const CliAuthUInt32 * constants_value_iter;
    CliAuthUInt32 * work_iter;
 
    t = _CLIAUTH_HASH_SHA1_ROUNDS_COUNT;
    j = _CLIAUTH_HASH_SHA1_ROUNDS_COUNT / _CLIAUTH_HASH_SHA1_ROUNDS_CONSTANTS_LENGTH;
-   schedule_iter = schedule;
    constants_function_iter = cliauth_hash_sha1_constants_rounds_function;
    constants_value_iter = cliauth_hash_sha1_constants_rounds_value;
 
@@ -358,7 +717,7 @@ cliauth_hash_sha1_perform_rounds_and_additions(
       b = (*constants_function_iter)(work[1], work[2], work[3]);
       c = work[4];
       d = *constants_value_iter;
-      e = *schedule_iter;
+      e = cliauth_hash_sha1_message_schedule_word(schedule, _CLIAUTH_HASH_SHA1_ROUNDS_COUNT - t);
       t1 = a + b + c + d + e;
 
       i = 4;
@@ -373,7 +732,6 @@ cliauth_hash_sha1_perform_rounds_and_additions(
       work[2] = cliauth_bitwise_rotate_left_uint32(work[2], 30);
       work[0] = t1;
 
-      schedule_iter++;
       t--;
       j--;
    }
@@ -415,10 +773,32 @@ cliauth_hash_sha1_digest_block(
    return;
 }
 
-static const struct CliAuthHashSha12RingBufferImplementation
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_HASH_SHA1_UNROLLED */
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+static void
+cliauth_hash_sha1_digest_block_x86_sha(
+   void * context,
+   const void * block
+) {
+   struct CliAuthHashContextSha1 * context_sha;
+
+   context_sha = (struct CliAuthHashContextSha1 *)context;
+
+   cliauth_hash_x86_sha1_digest_block_sha(context_sha->digest, block);
+
+   return;
+}
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/* not const since cliauth_hash_initialize() may replace the block digest */
+/* function with a hardware-accelerated one */
+static struct CliAuthHashSha12RingBufferImplementation
 cliauth_hash_sha1_ring_buffer_implementation = {
    cliauth_hash_sha1_digest_block,
-   _CLIAUTH_HASH_SHA1_BLOCK_LENGTH
+   _CLIAUTH_HASH_SHA1_BLOCK_LENGTH,
+   sizeof(CliAuthUInt64)
 };
 
 static const CliAuthUInt32
@@ -492,82 +872,346 @@ cliauth_hash_sha1_finalize(void * context, void * digest) {
    return;
 }
 
-const struct CliAuthHashFunction
-cliauth_hash_sha1 = {
-   cliauth_hash_sha1_initialize,
-   cliauth_hash_sha1_digest,
-   cliauth_hash_sha1_finalize
-};
-
-/*----------------------------------------------------------------------------*/
-#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+static void
+cliauth_hash_sha1_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   struct CliAuthHashContextSha1 * context_sha;
 
-#if _CLIAUTH_HASH_SHA2_32
-/*----------------------------------------------------------------------------*/
+   context_sha = (struct CliAuthHashContextSha1 *)context;
 
-static const CliAuthUInt32
-cliauth_hash_sha2_32_constants_rounds [_CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT] = {
-   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-   0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-   0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-   0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-   0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-   0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-   0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-   0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-   0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-};
+   cliauth_hash_sha1_2_ring_buffer_digest_finalize(
+      &cliauth_hash_sha1_ring_buffer_implementation,
+      &context_sha->ring_context,
+      context,
+      context_sha->ring_buffer,
+      message,
+      message_bytes
+   );
 
-static CliAuthUInt32
-cliauth_hash_sha2_32_sigma_u0(CliAuthUInt32 x) {
-   CliAuthUInt32 a, b, c;
+   cliauth_hash_sha1_2_digest_endian_host_to_big(
+      context_sha->digest,
+      sizeof(CliAuthUInt32),
+      _CLIAUTH_HASH_SHA1_DIGEST_WORDS_COUNT
+   );
 
-   a = cliauth_bitwise_rotate_right_uint32(x, 2);
-   b = cliauth_bitwise_rotate_right_uint32(x, 13);
-   c = cliauth_bitwise_rotate_right_uint32(x, 22);
+   (void)memcpy(digest, context_sha->digest, CLIAUTH_HASH_SHA1_DIGEST_LENGTH);
 
-   return cliauth_hash_sha1_2_32_parity(a, b, c);
+   return;
 }
 
-static CliAuthUInt32
-cliauth_hash_sha2_32_sigma_u1(CliAuthUInt32 x) {
-   CliAuthUInt32 a, b, c;
+static void
+cliauth_hash_sha1_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   struct _CliAuthHashSha12RingBufferContext * ring_contexts [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt8 * buffers [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthHashContextSha1 * context_sha;
+   CliAuthUInt32 lanes, lane;
 
-   a = cliauth_bitwise_rotate_right_uint32(x, 6);
-   b = cliauth_bitwise_rotate_right_uint32(x, 11);
-   c = cliauth_bitwise_rotate_right_uint32(x, 25);
+   while (count != 0) {
+      lanes = count;
+      if (lanes > CLIAUTH_HASH_LANES_MAX) {
+         lanes = CLIAUTH_HASH_LANES_MAX;
+      }
 
-   return cliauth_hash_sha1_2_32_parity(a, b, c);
-}
+      lane = 0;
+      while (lane != lanes) {
+         context_sha = (struct CliAuthHashContextSha1 *)contexts[lane];
+         ring_contexts[lane] = &context_sha->ring_context;
+         buffers[lane] = context_sha->ring_buffer;
+         lane++;
+      }
 
-static CliAuthUInt32
-cliauth_hash_sha2_32_sigma_l0(CliAuthUInt32 x) {
-   CliAuthUInt32 a, b, c;
+      cliauth_hash_sha1_2_ring_buffer_digest_finalize_multi(
+         &cliauth_hash_sha1_ring_buffer_implementation,
+         cliauth_hash_sha1_digest_block_multi,
+         ring_contexts,
+         buffers,
+         contexts,
+         messages,
+         message_bytes,
+         lanes
+      );
 
-   a = cliauth_bitwise_rotate_right_uint32(x, 7);
-   b = cliauth_bitwise_rotate_right_uint32(x, 18);
-   c = (x >> 3);
+      lane = 0;
+      while (lane != lanes) {
+         context_sha = (struct CliAuthHashContextSha1 *)contexts[lane];
 
-   return cliauth_hash_sha1_2_32_parity(a, b, c);
-}
+         cliauth_hash_sha1_2_digest_endian_host_to_big(
+            context_sha->digest,
+            sizeof(CliAuthUInt32),
+            _CLIAUTH_HASH_SHA1_DIGEST_WORDS_COUNT
+         );
 
-static CliAuthUInt32
-cliauth_hash_sha2_32_sigma_l1(CliAuthUInt32 x) {
-   CliAuthUInt32 a, b, c;
+         (void)memcpy(digests[lane], context_sha->digest, CLIAUTH_HASH_SHA1_DIGEST_LENGTH);
 
-   a = cliauth_bitwise_rotate_right_uint32(x, 17);
-   b = cliauth_bitwise_rotate_right_uint32(x, 19);
-   c = (x >> 10);
+         lane++;
+      }
 
-   return cliauth_hash_sha1_2_32_parity(a, b, c);
-}
+      contexts += lanes;
+      messages += lanes;
+      digests += lanes;
+      count -= lanes;
+   }
+
+   return;
+}
+
+static void
+cliauth_hash_sha1_export_state(const void * context, void * state) {
+   const struct CliAuthHashContextSha1 * context_sha;
+   struct CliAuthHashStateSha1 * state_sha;
+
+   context_sha = (const struct CliAuthHashContextSha1 *)context;
+   state_sha = (struct CliAuthHashStateSha1 *)state;
+
+   (void)memcpy(
+      state_sha->digest,
+      context_sha->digest,
+      _CLIAUTH_HASH_SHA1_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt32)
+   );
+   state_sha->total = context_sha->ring_context.total;
+
+   return;
+}
+
+static void
+cliauth_hash_sha1_import_state(void * context, const void * state) {
+   struct CliAuthHashContextSha1 * context_sha;
+   const struct CliAuthHashStateSha1 * state_sha;
+
+   context_sha = (struct CliAuthHashContextSha1 *)context;
+   state_sha = (const struct CliAuthHashStateSha1 *)state;
+
+   (void)memcpy(
+      context_sha->digest,
+      state_sha->digest,
+      _CLIAUTH_HASH_SHA1_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt32)
+   );
+
+   cliauth_hash_sha1_2_ring_buffer_resume(
+      &cliauth_hash_sha1_ring_buffer_implementation,
+      &context_sha->ring_context,
+      state_sha->total
+   );
+
+   return;
+}
+
+const struct CliAuthHashFunction
+cliauth_hash_sha1 = {
+   cliauth_hash_sha1_initialize,
+   cliauth_hash_sha1_digest,
+   cliauth_hash_sha1_finalize,
+   cliauth_hash_sha1_digest_finalize,
+   cliauth_hash_sha1_digest_block_multi,
+   cliauth_hash_sha1_digest_finalize_multi,
+   cliauth_hash_sha1_export_state,
+   cliauth_hash_sha1_import_state
+};
+
+typedef void (*CliAuthHashSha1DigestBlocksMulti)(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+);
+
+/* a multi-lane block compression function along with its lane count.  a */
+/* null function means the implementation isn't supported on this CPU. */
+struct CliAuthHashSha1MultiImplementation {
+   CliAuthHashSha1DigestBlocksMulti digest;
+   CliAuthUInt8 lanes;
+};
+
+/* multi-lane implementations sorted from most to least lanes, selected by */
+/* cliauth_hash_initialize() */
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+#define _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT 2
+#else /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+#define _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT 0
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+#if _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT != 0
+static struct CliAuthHashSha1MultiImplementation
+cliauth_hash_sha1_multi_implementations [_CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT] = {
+   {CLIAUTH_NULLPTR, CLIAUTH_HASH_X86_SHA1_LANES_AVX2},
+   {CLIAUTH_NULLPTR, CLIAUTH_HASH_X86_SHA1_LANES_SSE2}
+};
+#endif /* _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT != 0 */
+
+static void
+cliauth_hash_sha1_select(void) {
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+   CliAuthUInt32 features;
+
+   features = cliauth_cpu_x86_features();
+
+   if ((features & _CLIAUTH_HASH_X86_FEATURES_SHA) == _CLIAUTH_HASH_X86_FEATURES_SHA) {
+      cliauth_hash_sha1_ring_buffer_implementation.digest = cliauth_hash_sha1_digest_block_x86_sha;
+   }
+
+   if ((features & CLIAUTH_CPU_X86_FEATURE_AVX2) != 0) {
+      cliauth_hash_sha1_multi_implementations[0].digest = cliauth_hash_x86_sha1_digest_blocks_avx2;
+   }
+   /* a single SHA extension lane is faster than four SSE2 lanes, so only */
+   /* use SSE2 when the SHA extensions are unavailable */
+   if (
+      (features & CLIAUTH_CPU_X86_FEATURE_SSE2) != 0 &&
+      (features & _CLIAUTH_HASH_X86_FEATURES_SHA) != _CLIAUTH_HASH_X86_FEATURES_SHA
+   ) {
+      cliauth_hash_sha1_multi_implementations[1].digest = cliauth_hash_x86_sha1_digest_blocks_sse2;
+   }
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+   return;
+}
+
+/* digests 'lanes' blocks using the widest supported implementation which */
+/* fits, returning the number of lanes actually digested */
+static CliAuthUInt32
+cliauth_hash_sha1_digest_block_multi_chunk(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 * digests [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthHashContextSha1 * context_sha;
+#if _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT != 0
+   const struct CliAuthHashSha1MultiImplementation * implementation;
+   CliAuthUInt8 implementations_remaining;
+   CliAuthUInt8 lane;
+
+   implementation = cliauth_hash_sha1_multi_implementations;
+   implementations_remaining = _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT;
+   while (implementations_remaining != 0) {
+      if (implementation->digest != CLIAUTH_NULLPTR && count >= implementation->lanes) {
+         lane = 0;
+         while (lane != implementation->lanes) {
+            context_sha = (struct CliAuthHashContextSha1 *)contexts[lane];
+            context_sha->ring_context.total += _CLIAUTH_HASH_SHA1_BLOCK_LENGTH;
+            digests[lane] = context_sha->digest;
+            lane++;
+         }
+
+         implementation->digest(digests, blocks);
+
+         return implementation->lanes;
+      }
+
+      implementation++;
+      implementations_remaining--;
+   }
+#endif /* _CLIAUTH_HASH_SHA1_MULTI_IMPLEMENTATIONS_COUNT != 0 */
+
+   /* no multi-lane implementation fits, fall back to a single block */
+   (void)digests;
+   (void)count;
+   context_sha = (struct CliAuthHashContextSha1 *)contexts[0];
+   context_sha->ring_context.total += _CLIAUTH_HASH_SHA1_BLOCK_LENGTH;
+   cliauth_hash_sha1_ring_buffer_implementation.digest(context_sha, blocks[0]);
+
+   return 1;
+}
+
+void
+cliauth_hash_sha1_digest_block_multi(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 digested;
+
+   while (count != 0) {
+      digested = cliauth_hash_sha1_digest_block_multi_chunk(
+         contexts,
+         blocks,
+         count
+      );
+
+      contexts += digested;
+      blocks += digested;
+      count -= digested;
+   }
+
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+
+#if _CLIAUTH_HASH_SHA2_32
+/*----------------------------------------------------------------------------*/
+
+const CliAuthUInt32
+cliauth_hash_sha2_32_constants_rounds [_CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+   0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+   0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+   0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+   0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+   0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+   0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+   0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+   0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static CliAuthUInt32
+cliauth_hash_sha2_32_sigma_u0(CliAuthUInt32 x) {
+   CliAuthUInt32 a, b, c;
+
+   a = cliauth_bitwise_rotate_right_uint32(x, 2);
+   b = cliauth_bitwise_rotate_right_uint32(x, 13);
+   c = cliauth_bitwise_rotate_right_uint32(x, 22);
+
+   return cliauth_hash_sha1_2_32_parity(a, b, c);
+}
+
+static CliAuthUInt32
+cliauth_hash_sha2_32_sigma_u1(CliAuthUInt32 x) {
+   CliAuthUInt32 a, b, c;
+
+   a = cliauth_bitwise_rotate_right_uint32(x, 6);
+   b = cliauth_bitwise_rotate_right_uint32(x, 11);
+   c = cliauth_bitwise_rotate_right_uint32(x, 25);
+
+   return cliauth_hash_sha1_2_32_parity(a, b, c);
+}
+
+static CliAuthUInt32
+cliauth_hash_sha2_32_sigma_l0(CliAuthUInt32 x) {
+   CliAuthUInt32 a, b, c;
+
+   a = cliauth_bitwise_rotate_right_uint32(x, 7);
+   b = cliauth_bitwise_rotate_right_uint32(x, 18);
+   c = (x >> 3);
+
+   return cliauth_hash_sha1_2_32_parity(a, b, c);
+}
+
+static CliAuthUInt32
+cliauth_hash_sha2_32_sigma_l1(CliAuthUInt32 x) {
+   CliAuthUInt32 a, b, c;
+
+   a = cliauth_bitwise_rotate_right_uint32(x, 17);
+   b = cliauth_bitwise_rotate_right_uint32(x, 19);
+   c = (x >> 10);
+
+   return cliauth_hash_sha1_2_32_parity(a, b, c);
+}
 
 static void
 cliauth_hash_sha2_32_create_message_schedule(
@@ -575,8 +1219,10 @@ cliauth_hash_sha2_32_create_message_schedule(
    CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA2_32_MESSAGE_SCHEDULE_LENGTH]
 ) {
    CliAuthUInt32 * schedule_iter;
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
    CliAuthUInt32 a, b, c, d;
    CliAuthUInt8 t;
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
 
    schedule_iter = schedule;
 
@@ -587,6 +1233,7 @@ cliauth_hash_sha2_32_create_message_schedule(
       _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH,
       sizeof(CliAuthUInt32)
    );
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
    schedule_iter += _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH / sizeof(CliAuthUInt32);
 
    /* 16 <= t <= 63 */
@@ -602,24 +1249,45 @@ cliauth_hash_sha2_32_create_message_schedule(
       schedule_iter++;
       t--;
    }
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
 
    return;
 }
 
+/* retrieves the message schedule word for round 't'.  with a rolling */
+/* schedule, words past the first 16 are expanded in-place within the */
+/* 16-word window, so this must be called for each round in order. */
+static CliAuthUInt32
+cliauth_hash_sha2_32_message_schedule_word(
+   CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA2_32_MESSAGE_SCHEDULE_LENGTH],
+   CliAuthUInt8 t
+) {
+#if CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+   if (t >= 16) {
+      schedule[t & 15] +=
+         cliauth_hash_sha2_32_sigma_l1(schedule[(t - 2) & 15]) +
+         schedule[(t - 7) & 15] +
+         cliauth_hash_sha2_32_sigma_l0(schedule[(t - 15) & 15]);
+   }
+
+   return schedule[t & 15];
+#else /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+   return schedule[t];
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+}
+
 static void
 cliauth_hash_sha2_32_perform_rounds_and_additions(
    CliAuthUInt32 work [_CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT],
-   const CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA2_32_MESSAGE_SCHEDULE_LENGTH]
+   CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA2_32_MESSAGE_SCHEDULE_LENGTH]
 ) {
    CliAuthUInt8 t, i;
    CliAuthUInt32 a, b, c, d, e, f, g;
    CliAuthUInt32 t1, t2;
-   const CliAuthUInt32 * schedule_iter;
    const CliAuthUInt32 * constants_iter;
    CliAuthUInt32 * work_iter;
 
    t = _CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT;
-   schedule_iter = schedule;
    constants_iter = cliauth_hash_sha2_32_constants_rounds;
 
    while (t != 0) {
@@ -627,7 +1295,7 @@ cliauth_hash_sha2_32_perform_rounds_and_additions(
       b = cliauth_hash_sha2_32_sigma_u1(work[4]);
       c = cliauth_hash_sha1_2_32_ch(work[4], work[5], work[6]);
       d = *constants_iter;
-      e = *schedule_iter;
+      e = cliauth_hash_sha2_32_message_schedule_word(schedule, _CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT - t);
       t1 = a + b + c + d + e;
 
       f = cliauth_hash_sha2_32_sigma_u0(work[0]);
@@ -646,7 +1314,6 @@ cliauth_hash_sha2_32_perform_rounds_and_additions(
       work[4] = work[4] + t1;
       work[0] = t1 + t2;
 
-      schedule_iter++;
       constants_iter++;
       t--;
    }
@@ -692,12 +1359,215 @@ cliauth_hash_sha2_32_digest_block(
    return;
 }
 
-static const struct CliAuthHashSha12RingBufferImplementation
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+static void
+cliauth_hash_sha2_32_digest_block_x86_sha(
+   void * context,
+   const void * block
+) {
+   struct CliAuthHashContextSha232 * context_sha;
+
+   context_sha = (struct CliAuthHashContextSha232 *)context;
+
+   cliauth_hash_x86_sha2_32_digest_block_sha(context_sha->digest, block);
+
+   return;
+}
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+#define _CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES 2
+
+/* compresses independent blocks in interleaved scalar lanes.  the rounds of */
+/* each lane form a long dependency chain, so alternating between lanes each */
+/* round lets the CPU overlap their execution. */
+static void
+cliauth_hash_sha2_32_digest_blocks_interleaved(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+) {
+   CliAuthUInt32 schedule [_CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES][_CLIAUTH_HASH_SHA2_32_MESSAGE_SCHEDULE_LENGTH];
+   CliAuthUInt32 work [_CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES][_CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT];
+   CliAuthUInt32 * work_lane;
+   CliAuthUInt32 t1, t2;
+   CliAuthUInt8 lane, t;
+
+   lane = 0;
+   while (lane != _CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES) {
+      cliauth_hash_sha2_32_create_message_schedule(
+         (const CliAuthUInt8 *)blocks[lane],
+         schedule[lane]
+      );
+
+      (void)memcpy(
+         work[lane],
+         digests[lane],
+         _CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt32)
+      );
+
+      lane++;
+   }
+
+   t = 0;
+   while (t != _CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT) {
+      lane = 0;
+      while (lane != _CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES) {
+         work_lane = work[lane];
+
+         t1 =
+            work_lane[7] +
+            cliauth_hash_sha2_32_sigma_u1(work_lane[4]) +
+            cliauth_hash_sha1_2_32_ch(work_lane[4], work_lane[5], work_lane[6]) +
+            cliauth_hash_sha2_32_constants_rounds[t] +
+            cliauth_hash_sha2_32_message_schedule_word(schedule[lane], t);
+         t2 =
+            cliauth_hash_sha2_32_sigma_u0(work_lane[0]) +
+            cliauth_hash_sha1_2_32_maj(work_lane[0], work_lane[1], work_lane[2]);
+
+         work_lane[7] = work_lane[6];
+         work_lane[6] = work_lane[5];
+         work_lane[5] = work_lane[4];
+         work_lane[4] = work_lane[3] + t1;
+         work_lane[3] = work_lane[2];
+         work_lane[2] = work_lane[1];
+         work_lane[1] = work_lane[0];
+         work_lane[0] = t1 + t2;
+
+         lane++;
+      }
+
+      t++;
+   }
+
+   lane = 0;
+   while (lane != _CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES) {
+      cliauth_hash_sha1_2_32_compute_intermediate_digest(
+         work[lane],
+         digests[lane],
+         _CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT
+      );
+
+      lane++;
+   }
+
+   return;
+}
+
+/* not const since cliauth_hash_initialize() may replace the block digest */
+/* function with a hardware-accelerated one */
+static struct CliAuthHashSha12RingBufferImplementation
 cliauth_hash_sha2_32_ring_buffer_implementation = {
    cliauth_hash_sha2_32_digest_block,  
    _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH,
+   sizeof(CliAuthUInt64)
 };
 
+#define _CLIAUTH_HASH_SHA2_32_MULTI_LANES_MAX 2
+
+typedef void (*CliAuthHashSha232DigestBlocksMulti)(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+);
+
+/* a multi-lane block compression function along with its lane count.  a */
+/* null function means the implementation shouldn't be used on this CPU. */
+struct CliAuthHashSha232MultiImplementation {
+   CliAuthHashSha232DigestBlocksMulti digest;
+   CliAuthUInt8 lanes;
+};
+
+/* multi-lane implementations sorted from most to least lanes, selected by */
+/* cliauth_hash_initialize() */
+#define _CLIAUTH_HASH_SHA2_32_MULTI_IMPLEMENTATIONS_COUNT 1
+
+static struct CliAuthHashSha232MultiImplementation
+cliauth_hash_sha2_32_multi_implementations [_CLIAUTH_HASH_SHA2_32_MULTI_IMPLEMENTATIONS_COUNT] = {
+   {cliauth_hash_sha2_32_digest_blocks_interleaved, _CLIAUTH_HASH_SHA2_32_INTERLEAVED_LANES}
+};
+
+static void
+cliauth_hash_sha2_32_select(void) {
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+   CliAuthUInt32 features;
+
+   features = cliauth_cpu_x86_features();
+
+   /* a single block with the SHA extensions is much faster than any number */
+   /* of interleaved scalar lanes */
+   if ((features & _CLIAUTH_HASH_X86_FEATURES_SHA) == _CLIAUTH_HASH_X86_FEATURES_SHA) {
+      cliauth_hash_sha2_32_ring_buffer_implementation.digest = cliauth_hash_sha2_32_digest_block_x86_sha;
+      cliauth_hash_sha2_32_multi_implementations[0].digest = CLIAUTH_NULLPTR;
+   }
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+   return;
+}
+
+/* digests 'lanes' blocks using the widest supported implementation which */
+/* fits, returning the number of lanes actually digested */
+static CliAuthUInt32
+cliauth_hash_sha2_32_digest_block_multi_chunk(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 * digests [_CLIAUTH_HASH_SHA2_32_MULTI_LANES_MAX];
+   struct CliAuthHashContextSha232 * context_sha;
+   const struct CliAuthHashSha232MultiImplementation * implementation;
+   CliAuthUInt8 implementations_remaining;
+   CliAuthUInt8 lane;
+
+   implementation = cliauth_hash_sha2_32_multi_implementations;
+   implementations_remaining = _CLIAUTH_HASH_SHA2_32_MULTI_IMPLEMENTATIONS_COUNT;
+   while (implementations_remaining != 0) {
+      if (implementation->digest != CLIAUTH_NULLPTR && count >= implementation->lanes) {
+         lane = 0;
+         while (lane != implementation->lanes) {
+            context_sha = (struct CliAuthHashContextSha232 *)contexts[lane];
+            context_sha->ring_context.total += _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH;
+            digests[lane] = context_sha->digest;
+            lane++;
+         }
+
+         implementation->digest(digests, blocks);
+
+         return implementation->lanes;
+      }
+
+      implementation++;
+      implementations_remaining--;
+   }
+
+   /* no multi-lane implementation fits, fall back to a single block */
+   context_sha = (struct CliAuthHashContextSha232 *)contexts[0];
+   context_sha->ring_context.total += _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH;
+   cliauth_hash_sha2_32_ring_buffer_implementation.digest(context_sha, blocks[0]);
+
+   return 1;
+}
+
+void
+cliauth_hash_sha2_32_digest_block_multi(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 digested;
+
+   while (count != 0) {
+      digested = cliauth_hash_sha2_32_digest_block_multi_chunk(
+         contexts,
+         blocks,
+         count
+      );
+
+      contexts += digested;
+      blocks += digested;
+      count -= digested;
+   }
+
+   return;
+}
+
 static void
 cliauth_hash_sha2_32_initialize(
    void * context,
@@ -776,13 +1646,149 @@ cliauth_hash_sha2_32_finalize(
    return;
 }
 
+static void
+cliauth_hash_sha2_32_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt8 digest_length
+) {
+   struct CliAuthHashContextSha232 * context_sha;
+
+   context_sha = (struct CliAuthHashContextSha232 *)context;
+
+   cliauth_hash_sha1_2_ring_buffer_digest_finalize(
+      &cliauth_hash_sha2_32_ring_buffer_implementation,
+      &context_sha->ring_context,
+      context,
+      context_sha->ring_buffer,
+      message,
+      message_bytes
+   );
+
+   cliauth_hash_sha1_2_digest_endian_host_to_big(
+      context_sha->digest,
+      sizeof(CliAuthUInt32),
+      _CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT
+   );
+
+   (void)memcpy(digest, context_sha->digest, digest_length);
+
+   return;
+}
+
+static void
+cliauth_hash_sha2_32_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count,
+   CliAuthUInt8 digest_length
+) {
+   struct _CliAuthHashSha12RingBufferContext * ring_contexts [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt8 * buffers [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthHashContextSha232 * context_sha;
+   CliAuthUInt32 lanes, lane;
+
+   while (count != 0) {
+      lanes = count;
+      if (lanes > CLIAUTH_HASH_LANES_MAX) {
+         lanes = CLIAUTH_HASH_LANES_MAX;
+      }
+
+      lane = 0;
+      while (lane != lanes) {
+         context_sha = (struct CliAuthHashContextSha232 *)contexts[lane];
+         ring_contexts[lane] = &context_sha->ring_context;
+         buffers[lane] = context_sha->ring_buffer;
+         lane++;
+      }
+
+      cliauth_hash_sha1_2_ring_buffer_digest_finalize_multi(
+         &cliauth_hash_sha2_32_ring_buffer_implementation,
+         cliauth_hash_sha2_32_digest_block_multi,
+         ring_contexts,
+         buffers,
+         contexts,
+         messages,
+         message_bytes,
+         lanes
+      );
+
+      lane = 0;
+      while (lane != lanes) {
+         context_sha = (struct CliAuthHashContextSha232 *)contexts[lane];
+
+         cliauth_hash_sha1_2_digest_endian_host_to_big(
+            context_sha->digest,
+            sizeof(CliAuthUInt32),
+            _CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT
+         );
+
+         (void)memcpy(digests[lane], context_sha->digest, digest_length);
+
+         lane++;
+      }
+
+      contexts += lanes;
+      messages += lanes;
+      digests += lanes;
+      count -= lanes;
+   }
+
+   return;
+}
+
+static void
+cliauth_hash_sha2_32_export_state(const void * context, void * state) {
+   const struct CliAuthHashContextSha232 * context_sha;
+   struct CliAuthHashStateSha232 * state_sha;
+
+   context_sha = (const struct CliAuthHashContextSha232 *)context;
+   state_sha = (struct CliAuthHashStateSha232 *)state;
+
+   (void)memcpy(
+      state_sha->digest,
+      context_sha->digest,
+      _CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt32)
+   );
+   state_sha->total = context_sha->ring_context.total;
+
+   return;
+}
+
+static void
+cliauth_hash_sha2_32_import_state(void * context, const void * state) {
+   struct CliAuthHashContextSha232 * context_sha;
+   const struct CliAuthHashStateSha232 * state_sha;
+
+   context_sha = (struct CliAuthHashContextSha232 *)context;
+   state_sha = (const struct CliAuthHashStateSha232 *)state;
+
+   (void)memcpy(
+      context_sha->digest,
+      state_sha->digest,
+      _CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt32)
+   );
+
+   cliauth_hash_sha1_2_ring_buffer_resume(
+      &cliauth_hash_sha2_32_ring_buffer_implementation,
+      &context_sha->ring_context,
+      state_sha->total
+   );
+
+   return;
+}
+
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_HASH_SHA2_32 */
 
 #if _CLIAUTH_HASH_SHA2_64
 /*----------------------------------------------------------------------------*/
 
-static const CliAuthUInt64
+const CliAuthUInt64
 cliauth_hash_sha2_64_constants_rounds [_CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT] = {
    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
    0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
@@ -871,8 +1877,10 @@ cliauth_hash_sha2_64_create_message_schedule(
    CliAuthUInt64 schedule [_CLIAUTH_HASH_SHA2_64_MESSAGE_SCHEDULE_LENGTH]
 ) {
    CliAuthUInt64 * schedule_iter;
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
    CliAuthUInt64 a, b, c, d;
    CliAuthUInt8 t;
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
 
    schedule_iter = schedule;
 
@@ -883,6 +1891,7 @@ cliauth_hash_sha2_64_create_message_schedule(
       _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH,
       sizeof(CliAuthUInt64)
    );
+#if !CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
    schedule_iter += _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH / sizeof(CliAuthUInt64);
 
    /* 16 <= t <= 79 */
@@ -898,24 +1907,45 @@ cliauth_hash_sha2_64_create_message_schedule(
       schedule_iter++;
       t--;
    }
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
 
    return;
 }
 
+/* retrieves the message schedule word for round 't'.  with a rolling */
+/* schedule, words past the first 16 are expanded in-place within the */
+/* 16-word window, so this must be called for each round in order. */
+static CliAuthUInt64
+cliauth_hash_sha2_64_message_schedule_word(
+   CliAuthUInt64 schedule [_CLIAUTH_HASH_SHA2_64_MESSAGE_SCHEDULE_LENGTH],
+   CliAuthUInt8 t
+) {
+#if CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+   if (t >= 16) {
+      schedule[t & 15] +=
+         cliauth_hash_sha2_64_sigma_l1(schedule[(t - 2) & 15]) +
+         schedule[(t - 7) & 15] +
+         cliauth_hash_sha2_64_sigma_l0(schedule[(t - 15) & 15]);
+   }
+
+   return schedule[t & 15];
+#else /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+   return schedule[t];
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+}
+
 static void
 cliauth_hash_sha2_64_perform_rounds_and_additions(
    CliAuthUInt64 work [_CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT],
-   const CliAuthUInt64 schedule [_CLIAUTH_HASH_SHA2_64_MESSAGE_SCHEDULE_LENGTH]
+   CliAuthUInt64 schedule [_CLIAUTH_HASH_SHA2_64_MESSAGE_SCHEDULE_LENGTH]
 ) {
    CliAuthUInt8 t, i;
    CliAuthUInt64 a, b, c, d, e, f, g;
    CliAuthUInt64 t1, t2;
-   const CliAuthUInt64 * schedule_iter;
    const CliAuthUInt64 * constants_iter;
    CliAuthUInt64 * work_iter;
 
    t = _CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT;
-   schedule_iter = schedule;
    constants_iter = cliauth_hash_sha2_64_constants_rounds;
 
    while (t != 0) {
@@ -923,7 +1953,7 @@ cliauth_hash_sha2_64_perform_rounds_and_additions(
       b = cliauth_hash_sha2_64_sigma_u1(work[4]);
       c = cliauth_hash_sha2_64_ch(work[4], work[5], work[6]);
       d = *constants_iter;
-      e = *schedule_iter;
+      e = cliauth_hash_sha2_64_message_schedule_word(schedule, _CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT - t);
       t1 = a + b + c + d + e;
 
       f = cliauth_hash_sha2_64_sigma_u0(work[0]);
@@ -942,7 +1972,6 @@ cliauth_hash_sha2_64_perform_rounds_and_additions(
       work[4] = work[4] + t1;
       work[0] = t1 + t2;
 
-      schedule_iter++;
       constants_iter++;
       t--;
    }
@@ -981,38 +2010,153 @@ cliauth_hash_sha2_64_digest_block(
 ) {
    struct CliAuthHashContextSha264 * context_sha;
 
-   context_sha = (struct CliAuthHashContextSha264 *)context;
+   context_sha = (struct CliAuthHashContextSha264 *)context;
+
+   cliauth_hash_sha2_64_create_message_schedule(
+      (const CliAuthUInt8 *)block,
+      context_sha->schedule
+   );
+
+   (void)memcpy(
+      context_sha->work,
+      context_sha->digest,
+      _CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt64)
+   );
+
+   cliauth_hash_sha2_64_perform_rounds_and_additions(
+      context_sha->work,
+      context_sha->schedule
+   );
+
+   cliauth_hash_sha2_64_compute_intermediate_digest(
+      context_sha->digest,
+      context_sha->work
+   );
+   
+   return;
+}
+
+static const struct CliAuthHashSha12RingBufferImplementation
+cliauth_hash_sha2_64_ring_buffer_implementation = {
+   cliauth_hash_sha2_64_digest_block,  
+   _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH,
+   2 * sizeof(CliAuthUInt64)
+};
+
+#define _CLIAUTH_HASH_SHA2_64_MULTI_LANES_MAX 4
+
+typedef void (*CliAuthHashSha264DigestBlocksMulti)(
+   CliAuthUInt64 * const digests [],
+   const void * const blocks []
+);
+
+/* a multi-lane block compression function along with its lane count.  a */
+/* null function means the implementation isn't supported on this CPU. */
+struct CliAuthHashSha264MultiImplementation {
+   CliAuthHashSha264DigestBlocksMulti digest;
+   CliAuthUInt8 lanes;
+};
+
+/* multi-lane implementations sorted from most to least lanes, selected by */
+/* cliauth_hash_initialize() */
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+#define _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT 1
+#else /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+#define _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT 0
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+#if _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT != 0
+static struct CliAuthHashSha264MultiImplementation
+cliauth_hash_sha2_64_multi_implementations [_CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT] = {
+   {CLIAUTH_NULLPTR, CLIAUTH_HASH_X86_SHA2_64_LANES_AVX2}
+};
+#endif /* _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT != 0 */
+
+static void
+cliauth_hash_sha2_64_select(void) {
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+   CliAuthUInt32 features;
+
+   features = cliauth_cpu_x86_features();
+
+   if ((features & CLIAUTH_CPU_X86_FEATURE_AVX2) != 0) {
+      cliauth_hash_sha2_64_multi_implementations[0].digest = cliauth_hash_x86_sha2_64_digest_blocks_avx2;
+   }
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+   return;
+}
+
+/* digests 'lanes' blocks using the widest supported implementation which */
+/* fits, returning the number of lanes actually digested */
+static CliAuthUInt32
+cliauth_hash_sha2_64_digest_block_multi_chunk(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt64 * digests [_CLIAUTH_HASH_SHA2_64_MULTI_LANES_MAX];
+   struct CliAuthHashContextSha264 * context_sha;
+#if _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT != 0
+   const struct CliAuthHashSha264MultiImplementation * implementation;
+   CliAuthUInt8 implementations_remaining;
+   CliAuthUInt8 lane;
+
+   implementation = cliauth_hash_sha2_64_multi_implementations;
+   implementations_remaining = _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT;
+   while (implementations_remaining != 0) {
+      if (implementation->digest != CLIAUTH_NULLPTR && count >= implementation->lanes) {
+         lane = 0;
+         while (lane != implementation->lanes) {
+            context_sha = (struct CliAuthHashContextSha264 *)contexts[lane];
+            context_sha->ring_context.total += _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH;
+            digests[lane] = context_sha->digest;
+            lane++;
+         }
+
+         implementation->digest(digests, blocks);
+
+         return implementation->lanes;
+      }
+
+      implementation++;
+      implementations_remaining--;
+   }
+#endif /* _CLIAUTH_HASH_SHA2_64_MULTI_IMPLEMENTATIONS_COUNT != 0 */
 
-   cliauth_hash_sha2_64_create_message_schedule(
-      (const CliAuthUInt8 *)block,
-      context_sha->schedule
-   );
+   /* no multi-lane implementation fits, fall back to a single block */
+   (void)digests;
+   (void)count;
+   context_sha = (struct CliAuthHashContextSha264 *)contexts[0];
+   context_sha->ring_context.total += _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH;
+   cliauth_hash_sha2_64_ring_buffer_implementation.digest(context_sha, blocks[0]);
 
-   (void)memcpy(
-      context_sha->work,
-      context_sha->digest,
-      _CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt64)
-   );
+   return 1;
+}
 
-   cliauth_hash_sha2_64_perform_rounds_and_additions(
-      context_sha->work,
-      context_sha->schedule
-   );
+void
+cliauth_hash_sha2_64_digest_block_multi(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 digested;
+
+   while (count != 0) {
+      digested = cliauth_hash_sha2_64_digest_block_multi_chunk(
+         contexts,
+         blocks,
+         count
+      );
+
+      contexts += digested;
+      blocks += digested;
+      count -= digested;
+   }
 
-   cliauth_hash_sha2_64_compute_intermediate_digest(
-      context_sha->digest,
-      context_sha->work
-   );
-   
    return;
 }
 
-static const struct CliAuthHashSha12RingBufferImplementation
-cliauth_hash_sha2_64_ring_buffer_implementation = {
-   cliauth_hash_sha2_64_digest_block,  
-   _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH,
-};
-
 static void
 cliauth_hash_sha2_64_initialize(
    void * context,
@@ -1086,6 +2230,142 @@ cliauth_hash_sha2_64_finalize(
    return;
 }
 
+static void
+cliauth_hash_sha2_64_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt8 digest_length
+) {
+   struct CliAuthHashContextSha264 * context_sha;
+
+   context_sha = (struct CliAuthHashContextSha264 *)context;
+
+   cliauth_hash_sha1_2_ring_buffer_digest_finalize(
+      &cliauth_hash_sha2_64_ring_buffer_implementation,
+      &context_sha->ring_context,
+      context,
+      context_sha->ring_buffer,
+      message,
+      message_bytes
+   );
+
+   cliauth_hash_sha1_2_digest_endian_host_to_big(
+      context_sha->digest,
+      sizeof(CliAuthUInt64),
+      _CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT
+   );
+
+   (void)memcpy(digest, context_sha->digest, digest_length);
+
+   return;
+}
+
+static void
+cliauth_hash_sha2_64_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count,
+   CliAuthUInt8 digest_length
+) {
+   struct _CliAuthHashSha12RingBufferContext * ring_contexts [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt8 * buffers [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthHashContextSha264 * context_sha;
+   CliAuthUInt32 lanes, lane;
+
+   while (count != 0) {
+      lanes = count;
+      if (lanes > CLIAUTH_HASH_LANES_MAX) {
+         lanes = CLIAUTH_HASH_LANES_MAX;
+      }
+
+      lane = 0;
+      while (lane != lanes) {
+         context_sha = (struct CliAuthHashContextSha264 *)contexts[lane];
+         ring_contexts[lane] = &context_sha->ring_context;
+         buffers[lane] = context_sha->ring_buffer;
+         lane++;
+      }
+
+      cliauth_hash_sha1_2_ring_buffer_digest_finalize_multi(
+         &cliauth_hash_sha2_64_ring_buffer_implementation,
+         cliauth_hash_sha2_64_digest_block_multi,
+         ring_contexts,
+         buffers,
+         contexts,
+         messages,
+         message_bytes,
+         lanes
+      );
+
+      lane = 0;
+      while (lane != lanes) {
+         context_sha = (struct CliAuthHashContextSha264 *)contexts[lane];
+
+         cliauth_hash_sha1_2_digest_endian_host_to_big(
+            context_sha->digest,
+            sizeof(CliAuthUInt64),
+            _CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT
+         );
+
+         (void)memcpy(digests[lane], context_sha->digest, digest_length);
+
+         lane++;
+      }
+
+      contexts += lanes;
+      messages += lanes;
+      digests += lanes;
+      count -= lanes;
+   }
+
+   return;
+}
+
+static void
+cliauth_hash_sha2_64_export_state(const void * context, void * state) {
+   const struct CliAuthHashContextSha264 * context_sha;
+   struct CliAuthHashStateSha264 * state_sha;
+
+   context_sha = (const struct CliAuthHashContextSha264 *)context;
+   state_sha = (struct CliAuthHashStateSha264 *)state;
+
+   (void)memcpy(
+      state_sha->digest,
+      context_sha->digest,
+      _CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt64)
+   );
+   state_sha->total = context_sha->ring_context.total;
+
+   return;
+}
+
+static void
+cliauth_hash_sha2_64_import_state(void * context, const void * state) {
+   struct CliAuthHashContextSha264 * context_sha;
+   const struct CliAuthHashStateSha264 * state_sha;
+
+   context_sha = (struct CliAuthHashContextSha264 *)context;
+   state_sha = (const struct CliAuthHashStateSha264 *)state;
+
+   (void)memcpy(
+      context_sha->digest,
+      state_sha->digest,
+      _CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT * sizeof(CliAuthUInt64)
+   );
+
+   cliauth_hash_sha1_2_ring_buffer_resume(
+      &cliauth_hash_sha2_64_ring_buffer_implementation,
+      &context_sha->ring_context,
+      state_sha->total
+   );
+
+   return;
+}
+
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_HASH_SHA2_64 */
 
@@ -1110,11 +2390,39 @@ cliauth_hash_sha224_finalize(void * context, void * digest) {
    return;
 }
 
+static void
+cliauth_hash_sha224_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   cliauth_hash_sha2_32_digest_finalize(context, message, digest, message_bytes, CLIAUTH_HASH_SHA224_DIGEST_LENGTH);
+   return;
+}
+
+static void
+cliauth_hash_sha224_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_hash_sha2_32_digest_finalize_multi(contexts, messages, digests, message_bytes, count, CLIAUTH_HASH_SHA224_DIGEST_LENGTH);
+   return;
+}
+
 const struct CliAuthHashFunction
 cliauth_hash_sha224 = {
    cliauth_hash_sha224_initialize,
    cliauth_hash_sha2_32_digest,
-   cliauth_hash_sha224_finalize
+   cliauth_hash_sha224_finalize,
+   cliauth_hash_sha224_digest_finalize,
+   cliauth_hash_sha2_32_digest_block_multi,
+   cliauth_hash_sha224_digest_finalize_multi,
+   cliauth_hash_sha2_32_export_state,
+   cliauth_hash_sha2_32_import_state
 };
 
 /*----------------------------------------------------------------------------*/
@@ -1141,11 +2449,39 @@ cliauth_hash_sha256_finalize(void * context, void * digest) {
    return;
 }
 
+static void
+cliauth_hash_sha256_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   cliauth_hash_sha2_32_digest_finalize(context, message, digest, message_bytes, CLIAUTH_HASH_SHA256_DIGEST_LENGTH);
+   return;
+}
+
+static void
+cliauth_hash_sha256_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_hash_sha2_32_digest_finalize_multi(contexts, messages, digests, message_bytes, count, CLIAUTH_HASH_SHA256_DIGEST_LENGTH);
+   return;
+}
+
 const struct CliAuthHashFunction
 cliauth_hash_sha256 = {
    cliauth_hash_sha256_initialize,
    cliauth_hash_sha2_32_digest,
-   cliauth_hash_sha256_finalize
+   cliauth_hash_sha256_finalize,
+   cliauth_hash_sha256_digest_finalize,
+   cliauth_hash_sha2_32_digest_block_multi,
+   cliauth_hash_sha256_digest_finalize_multi,
+   cliauth_hash_sha2_32_export_state,
+   cliauth_hash_sha2_32_import_state
 };
 
 /*----------------------------------------------------------------------------*/
@@ -1172,11 +2508,39 @@ cliauth_hash_sha384_finalize(void * context, void * digest) {
    return;
 }
 
+static void
+cliauth_hash_sha384_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   cliauth_hash_sha2_64_digest_finalize(context, message, digest, message_bytes, CLIAUTH_HASH_SHA384_DIGEST_LENGTH);
+   return;
+}
+
+static void
+cliauth_hash_sha384_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_hash_sha2_64_digest_finalize_multi(contexts, messages, digests, message_bytes, count, CLIAUTH_HASH_SHA384_DIGEST_LENGTH);
+   return;
+}
+
 const struct CliAuthHashFunction
 cliauth_hash_sha384 = {
    cliauth_hash_sha384_initialize,
    cliauth_hash_sha2_64_digest,
-   cliauth_hash_sha384_finalize
+   cliauth_hash_sha384_finalize,
+   cliauth_hash_sha384_digest_finalize,
+   cliauth_hash_sha2_64_digest_block_multi,
+   cliauth_hash_sha384_digest_finalize_multi,
+   cliauth_hash_sha2_64_export_state,
+   cliauth_hash_sha2_64_import_state
 };
 
 /*----------------------------------------------------------------------------*/
@@ -1203,11 +2567,39 @@ cliauth_hash_sha512_finalize(void * context, void * digest) {
    return;
 }
 
+static void
+cliauth_hash_sha512_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   cliauth_hash_sha2_64_digest_finalize(context, message, digest, message_bytes, CLIAUTH_HASH_SHA512_DIGEST_LENGTH);
+   return;
+}
+
+static void
+cliauth_hash_sha512_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_hash_sha2_64_digest_finalize_multi(contexts, messages, digests, message_bytes, count, CLIAUTH_HASH_SHA512_DIGEST_LENGTH);
+   return;
+}
+
 const struct CliAuthHashFunction
 cliauth_hash_sha512 = {
    cliauth_hash_sha512_initialize,
    cliauth_hash_sha2_64_digest,
-   cliauth_hash_sha512_finalize
+   cliauth_hash_sha512_finalize,
+   cliauth_hash_sha512_digest_finalize,
+   cliauth_hash_sha2_64_digest_block_multi,
+   cliauth_hash_sha512_digest_finalize_multi,
+   cliauth_hash_sha2_64_export_state,
+   cliauth_hash_sha2_64_import_state
 };
 
 /*----------------------------------------------------------------------------*/
@@ -1234,11 +2626,39 @@ cliauth_hash_sha512_224_finalize(void * context, void * digest) {
    return;
 }
 
+static void
+cliauth_hash_sha512_224_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   cliauth_hash_sha2_64_digest_finalize(context, message, digest, message_bytes, CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH);
+   return;
+}
+
+static void
+cliauth_hash_sha512_224_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_hash_sha2_64_digest_finalize_multi(contexts, messages, digests, message_bytes, count, CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH);
+   return;
+}
+
 const struct CliAuthHashFunction
 cliauth_hash_sha512_224 = {
    cliauth_hash_sha512_224_initialize,
    cliauth_hash_sha2_64_digest,
-   cliauth_hash_sha512_224_finalize
+   cliauth_hash_sha512_224_finalize,
+   cliauth_hash_sha512_224_digest_finalize,
+   cliauth_hash_sha2_64_digest_block_multi,
+   cliauth_hash_sha512_224_digest_finalize_multi,
+   cliauth_hash_sha2_64_export_state,
+   cliauth_hash_sha2_64_import_state
 };
 
 /*----------------------------------------------------------------------------*/
@@ -1265,13 +2685,218 @@ cliauth_hash_sha512_256_finalize(void * context, void * digest) {
    return;
 }
 
+static void
+cliauth_hash_sha512_256_digest_finalize(
+   void * context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   cliauth_hash_sha2_64_digest_finalize(context, message, digest, message_bytes, CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH);
+   return;
+}
+
+static void
+cliauth_hash_sha512_256_digest_finalize_multi(
+   void * const contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_hash_sha2_64_digest_finalize_multi(contexts, messages, digests, message_bytes, count, CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH);
+   return;
+}
+
 const struct CliAuthHashFunction
 cliauth_hash_sha512_256 = {
    cliauth_hash_sha512_256_initialize,
    cliauth_hash_sha2_64_digest,
-   cliauth_hash_sha512_256_finalize
+   cliauth_hash_sha512_256_finalize,
+   cliauth_hash_sha512_256_digest_finalize,
+   cliauth_hash_sha2_64_digest_block_multi,
+   cliauth_hash_sha512_256_digest_finalize_multi,
+   cliauth_hash_sha2_64_export_state,
+   cliauth_hash_sha2_64_import_state
 };
 
 /*----------------------------------------------------------------------------*/
 #endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
 
+void
+cliauth_hash_initialize(void) {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   cliauth_hash_sha1_select();
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if _CLIAUTH_HASH_SHA2_32
+   cliauth_hash_sha2_32_select();
+#endif /* _CLIAUTH_HASH_SHA2_32 */
+#if _CLIAUTH_HASH_SHA2_64
+   cliauth_hash_sha2_64_select();
+#endif /* _CLIAUTH_HASH_SHA2_64 */
+
+   return;
+}
+
+
+void
+cliauth_hash_lanes_initialize(
+   struct CliAuthHashLanes * lanes,
+   const struct CliAuthHashFunction * hash_function,
+   CliAuthUInt32 block_bytes
+) {
+   lanes->hash_function = hash_function;
+   lanes->block_bytes = block_bytes;
+   lanes->lanes_used = 0;
+   lanes->completed_count = 0;
+
+   return;
+}
+
+/* removes the job in a lane, moving the last occupied lane into its place */
+static void
+cliauth_hash_lanes_remove(
+   struct CliAuthHashLanes * lanes,
+   CliAuthUInt32 lane
+) {
+   CliAuthUInt32 lane_last;
+
+   lane_last = lanes->lanes_used - 1;
+   lanes->jobs[lane] = lanes->jobs[lane_last];
+   lanes->blocks_next[lane] = lanes->blocks_next[lane_last];
+   lanes->blocks_remaining[lane] = lanes->blocks_remaining[lane_last];
+   lanes->lanes_used = lane_last;
+
+   return;
+}
+
+/* digests blocks into every occupied lane until the shortest job has no */
+/* full blocks left, then completes it along with every other job which has */
+/* no full blocks left and the same number of bytes left over, finishing */
+/* them all in the lanes of a single 'digest_finalize_multi' */
+static void
+cliauth_hash_lanes_run(
+   struct CliAuthHashLanes * lanes
+) {
+   void * contexts [CLIAUTH_HASH_LANES_MAX];
+   const void * messages [CLIAUTH_HASH_LANES_MAX];
+   void * digests [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthHashJob * job;
+   CliAuthUInt32 lane, lane_shortest;
+   CliAuthUInt32 blocks, tail_bytes, count;
+
+   lane_shortest = 0;
+   lane = 0;
+   while (lane != lanes->lanes_used) {
+      contexts[lane] = lanes->jobs[lane]->context;
+
+      if (lanes->blocks_remaining[lane] < lanes->blocks_remaining[lane_shortest]) {
+         lane_shortest = lane;
+      }
+
+      lane++;
+   }
+
+   blocks = lanes->blocks_remaining[lane_shortest];
+   while (blocks != 0) {
+      lane = 0;
+      while (lane != lanes->lanes_used) {
+         messages[lane] = lanes->blocks_next[lane];
+         lanes->blocks_next[lane] += lanes->block_bytes;
+         lanes->blocks_remaining[lane]--;
+         lane++;
+      }
+
+      lanes->hash_function->digest_block_multi(
+         contexts,
+         messages,
+         lanes->lanes_used
+      );
+
+      blocks--;
+   }
+
+   /* gather every job to finish alongside the shortest.  removing a lane */
+   /* moves the last lane into its place, so the same lane is checked again */
+   tail_bytes = lanes->jobs[lane_shortest]->message_bytes % lanes->block_bytes;
+   count = 0;
+   lane = 0;
+   while (lane != lanes->lanes_used) {
+      job = lanes->jobs[lane];
+
+      if (
+         lanes->blocks_remaining[lane] == 0 &&
+         job->message_bytes % lanes->block_bytes == tail_bytes
+      ) {
+         contexts[count] = job->context;
+         messages[count] = lanes->blocks_next[lane];
+         digests[count] = job->digest;
+         count++;
+
+         lanes->completed[lanes->completed_count] = job;
+         lanes->completed_count++;
+
+         cliauth_hash_lanes_remove(lanes, lane);
+      } else {
+         lane++;
+      }
+   }
+
+   lanes->hash_function->digest_finalize_multi(
+      contexts,
+      messages,
+      digests,
+      tail_bytes,
+      count
+   );
+
+   return;
+}
+
+void
+cliauth_hash_lanes_submit(
+   struct CliAuthHashLanes * lanes,
+   struct CliAuthHashJob * job
+) {
+   CliAuthUInt32 lane;
+
+   lane = lanes->lanes_used;
+   lanes->jobs[lane] = job;
+   lanes->blocks_next[lane] = (const CliAuthUInt8 *)job->message;
+   lanes->blocks_remaining[lane] = job->message_bytes / lanes->block_bytes;
+   lanes->lanes_used++;
+
+   /* wait for more jobs until every lane is occupied */
+   if (lanes->lanes_used == CLIAUTH_HASH_LANES_MAX) {
+      cliauth_hash_lanes_run(lanes);
+   }
+
+   return;
+}
+
+struct CliAuthHashJob *
+cliauth_hash_lanes_complete(
+   struct CliAuthHashLanes * lanes
+) {
+   if (lanes->completed_count == 0) {
+      return CLIAUTH_NULLPTR;
+   }
+
+   lanes->completed_count--;
+   return lanes->completed[lanes->completed_count];
+}
+
+struct CliAuthHashJob *
+cliauth_hash_lanes_flush(
+   struct CliAuthHashLanes * lanes
+) {
+   if (lanes->completed_count == 0) {
+      if (lanes->lanes_used == 0) {
+         return CLIAUTH_NULLPTR;
+      }
+
+      cliauth_hash_lanes_run(lanes);
+   }
+
+   return cliauth_hash_lanes_complete(lanes);
+}
@@ -59,6 +59,17 @@
       _CLIAUTH_HASH_SHA2_64\
    )
 
+/* the number of message schedule words kept in each context.  with a */
+/* rolling schedule, only a 16-word window is kept and expanded on the fly */
+/* during the rounds, otherwise the full schedule is expanded up-front. */
+#if CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE
+#define _CLIAUTH_HASH_MESSAGE_SCHEDULE_LENGTH(rounds)\
+   16
+#else /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+#define _CLIAUTH_HASH_MESSAGE_SCHEDULE_LENGTH(rounds)\
+   (rounds)
+#endif /* CLIAUTH_CONFIG_HASH_ROLLING_SCHEDULE */
+
 /* enable shared constants and functions for all SHA1 and SHA2 function */
 #define _CLIAUTH_HASH_SHA1_2\
    (\
@@ -82,10 +93,36 @@
 /* digest - A byte buffer to store the final hash value in.  The length of    */
 /*          the buffer should be at least the size defined in the function's  */
 /*          documentation.                                                    */
+/*                                                                            */
+/* state - Pointer to a function-specific state struct instance as defined in */
+/*         the function's documentation.  A state is a compact snapshot of a  */
+/*         context after a whole number of input blocks has been digested.    */
+/*                                                                            */
+/* contexts - An array of 'count' pointers to contexts.                       */
+/*                                                                            */
+/* blocks - An array of 'count' pointers to full input blocks, where each     */
+/*          block is digested into the context at the same index.  Multiple   */
+/*          entries may point to the same block.                              */
+/*                                                                            */
+/* messages - An array of 'count' pointers to arbitrary byte data of length   */
+/*            'bytes', where each message is digested into the context at the */
+/*            same index.  Multiple entries may point to the same message.    */
+/*                                                                            */
+/* digests - An array of 'count' byte buffers to store the final hash values  */
+/*           in, where each buffer receives the hash value of the context at  */
+/*           the same index.                                                  */
+/*                                                                            */
+/* count - The number of entries in 'contexts', 'blocks', 'messages', and     */
+/*         'digests'.                                                         */
 /*----------------------------------------------------------------------------*/
 typedef void (*CliAuthHashFunctionInitialize)(void * context);
 typedef void (*CliAuthHashFunctionDigest)(void * context, const void * message, CliAuthUInt32 bytes);
 typedef void (*CliAuthHashFunctionFinalize)(void * context, void * digest);
+typedef void (*CliAuthHashFunctionDigestFinalize)(void * context, const void * message, void * digest, CliAuthUInt32 bytes);
+typedef void (*CliAuthHashFunctionDigestBlockMulti)(void * const contexts [], const void * const blocks [], CliAuthUInt32 count);
+typedef void (*CliAuthHashFunctionDigestFinalizeMulti)(void * const contexts [], const void * const messages [], void * const digests [], CliAuthUInt32 bytes, CliAuthUInt32 count);
+typedef void (*CliAuthHashFunctionExportState)(const void * context, void * state);
+typedef void (*CliAuthHashFunctionImportState)(void * context, const void * state);
 
 /*----------------------------------------------------------------------------*/
 /* A generic hash function represented by its function pointers.              */
@@ -98,13 +135,57 @@ typedef void (*CliAuthHashFunctionFinalize)(void * context, void * digest);
 /* finalize - Finalizes the hash function and writes the digest, invalidating */
 /*            the internal state.  To start a new hash, 'initialize' must be  */
 /*            called again.                                                   */
+/*                                                                            */
+/* digest_finalize - Digests a final array of arbitrary data and finalizes,   */
+/*                   with the same result as 'digest' followed by 'finalize'. */
+/*                   This is faster when the context has digested a multiple  */
+/*                   of the input block length and the data fits in a single  */
+/*                   padded block, such as an HMAC message following a pad    */
+/*                   block.  'message' and 'digest' may be the same buffer.   */
+/*                                                                            */
+/* digest_block_multi - Digests one full input block into each of several     */
+/*                      independent contexts, compressing them in parallel    */
+/*                      lanes where the implementation allows it.  Each       */
+/*                      context must have digested a whole number of input    */
+/*                      blocks.                                               */
+/*                                                                            */
+/* digest_finalize_multi - Performs 'digest_finalize' on several independent  */
+/*                         contexts with messages of the same length.  When   */
+/*                         every message fits in a single padded block, the   */
+/*                         final blocks are compressed in parallel lanes, and */
+/*                         contexts sharing a message and total length share  */
+/*                         a single final block.  Each message may be the     */
+/*                         same buffer as its digest.                         */
+/*                                                                            */
+/* export_state - Saves the state of a context into a state struct.  The      */
+/*                total number of bytes digested by the context must be a     */
+/*                multiple of the input block length.  The context is left    */
+/*                unmodified.                                                 */
+/*                                                                            */
+/* import_state - Initializes a context from a previously exported state,     */
+/*                resuming the hash as if the original input had been         */
+/*                digested again.  This may be used in place of 'initialize'. */
 /*----------------------------------------------------------------------------*/
 struct CliAuthHashFunction {
-   CliAuthHashFunctionInitialize initialize;
-   CliAuthHashFunctionDigest     digest;
-   CliAuthHashFunctionFinalize   finalize;
+   CliAuthHashFunctionInitialize           initialize;
+   CliAuthHashFunctionDigest               digest;
+   CliAuthHashFunctionFinalize             finalize;
+   CliAuthHashFunctionDigestFinalize       digest_finalize;
+   CliAuthHashFunctionDigestBlockMulti     digest_block_multi;
+   CliAuthHashFunctionDigestFinalizeMulti  digest_finalize_multi;
+   CliAuthHashFunctionExportState          export_state;
+   CliAuthHashFunctionImportState          import_state;
 };
 
+/*----------------------------------------------------------------------------*/
+/* Selects the fastest block compression implementations supported by the     */
+/* host CPU.  This should be called once at startup after                     */
+/* cliauth_cpu_initialize() and before any other threads are created.  Until  */
+/* this is called, the portable implementations will be used.                 */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_hash_initialize(void);
+
 #if _CLIAUTH_HASH_SHA1_2
 /*----------------------------------------------------------------------------*/
 
@@ -131,7 +212,7 @@ struct _CliAuthHashSha12RingBufferContext {
 #define _CLIAUTH_HASH_SHA1_ROUNDS_COUNT\
    80
 #define _CLIAUTH_HASH_SHA1_MESSAGE_SCHEDULE_LENGTH\
-   _CLIAUTH_HASH_SHA1_ROUNDS_COUNT
+   _CLIAUTH_HASH_MESSAGE_SCHEDULE_LENGTH(_CLIAUTH_HASH_SHA1_ROUNDS_COUNT)
 #define _CLIAUTH_HASH_SHA1_ROUNDS_CONSTANTS_LENGTH\
    4
 
@@ -146,11 +227,21 @@ struct CliAuthHashContextSha1 {
    struct _CliAuthHashSha12RingBufferContext ring_context;
 };
 
+/*----------------------------------------------------------------------------*/
+/* State struct to be used with the SHA1 function.                            */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashStateSha1 {
+   CliAuthUInt32 digest [_CLIAUTH_HASH_SHA1_DIGEST_WORDS_COUNT];
+   CliAuthUInt64 total;
+};
+
 /*----------------------------------------------------------------------------*/
 /* SHA1 function.                                                             */
 /*----------------------------------------------------------------------------*/
 /* The type of 'context' should be CliAuthHashContextSha1.                    */
 /*                                                                            */
+/* The type of 'state' should be CliAuthHashStateSha1.                        */
+/*                                                                            */
 /* The length of 'digest' is CLIAUTH_HASH_SHA1_DIGEST_LENGTH.                 */
 /*----------------------------------------------------------------------------*/
 #define CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH _CLIAUTH_HASH_SHA1_BLOCK_LENGTH
@@ -158,6 +249,30 @@ struct CliAuthHashContextSha1 {
 extern const struct CliAuthHashFunction
 cliauth_hash_sha1;
 
+/*----------------------------------------------------------------------------*/
+/* Digests one full input block into each of several independent SHA1         */
+/* contexts in lock-step.  This has the same effect as calling 'digest' on    */
+/* each context with CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH bytes, but the      */
+/* blocks are compressed in parallel SIMD lanes when the host CPU allows it.  */
+/*----------------------------------------------------------------------------*/
+/* contexts - An array of 'count' pointers to initialized contexts of type    */
+/*            CliAuthHashContextSha1.  Each context must have only digested a */
+/*            whole number of input blocks.                                   */
+/*                                                                            */
+/* blocks - An array of 'count' pointers to input blocks of length            */
+/*          CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH, where each block is         */
+/*          digested into the context at the same index.  Multiple entries    */
+/*          may point to the same block.                                      */
+/*                                                                            */
+/* count - The number of entries in 'contexts' and 'blocks'.                  */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_hash_sha1_digest_block_multi(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+);
+
 /*----------------------------------------------------------------------------*/
 #endif /* CLIAUTH_CONFIG_HASH_SHA1 */
    
@@ -172,7 +287,11 @@ cliauth_hash_sha1;
 #define _CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT\
    64
 #define _CLIAUTH_HASH_SHA2_32_MESSAGE_SCHEDULE_LENGTH\
-   _CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT
+   _CLIAUTH_HASH_MESSAGE_SCHEDULE_LENGTH(_CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT)
+
+/* round constants for 32-bit SHA2, shared with the x86 implementations */
+extern const CliAuthUInt32
+cliauth_hash_sha2_32_constants_rounds [_CLIAUTH_HASH_SHA2_32_ROUNDS_COUNT];
 
 /*----------------------------------------------------------------------------*/
 /* Context struct to be used with SHA2-32 class functions.                    */
@@ -195,15 +314,51 @@ struct CliAuthHashContextSha232 {
 
 };
 
+/*----------------------------------------------------------------------------*/
+/* State struct to be used with SHA2-32 class functions.                      */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashStateSha232 {
+   CliAuthUInt32 digest [_CLIAUTH_HASH_SHA2_32_DIGEST_WORDS_COUNT];
+   CliAuthUInt64 total;
+};
+
 /*----------------------------------------------------------------------------*/
 /* SHA2-32 class functions.                                                   */
 /*----------------------------------------------------------------------------*/
 /* The type of 'context' should be CliAuthHashContextSha232.                  */
 /*                                                                            */
+/* The type of 'state' should be CliAuthHashStateSha232.                      */
+/*                                                                            */
 /* The length of 'digest' is CLIAUTH_HASH_SHA224_DIGEST_LENGTH or             */
 /* CLIAUTH_HASH_SHA256_DIGEST_LENGTH, depending on the specific algorithm.    */
 /*----------------------------------------------------------------------------*/
 
+/*----------------------------------------------------------------------------*/
+/* Digests one full input block into each of several independent SHA2-32      */
+/* contexts in lock-step.  This has the same effect as calling 'digest' on    */
+/* each context with _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH bytes, but the blocks */
+/* are compressed in interleaved lanes when the host CPU lacks the SHA        */
+/* extensions.  The contexts may belong to any mix of SHA2-32 class           */
+/* algorithms.                                                                */
+/*----------------------------------------------------------------------------*/
+/* contexts - An array of 'count' pointers to initialized contexts of type    */
+/*            CliAuthHashContextSha232.  Each context must have only digested */
+/*            a whole number of input blocks.                                 */
+/*                                                                            */
+/* blocks - An array of 'count' pointers to input blocks of length            */
+/*          _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH, where each block is digested  */
+/*          into the context at the same index.  Multiple entries may point   */
+/*          to the same block.                                                */
+/*                                                                            */
+/* count - The number of entries in 'contexts' and 'blocks'.                  */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_hash_sha2_32_digest_block_multi(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+);
+
 #if CLIAUTH_CONFIG_HASH_SHA224
 #define CLIAUTH_HASH_SHA224_INPUT_BLOCK_LENGTH _CLIAUTH_HASH_SHA2_32_BLOCK_LENGTH
 #define CLIAUTH_HASH_SHA224_DIGEST_LENGTH 28
@@ -232,7 +387,11 @@ cliauth_hash_sha256;
 #define _CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT\
    80
 #define _CLIAUTH_HASH_SHA2_64_MESSAGE_SCHEDULE_LENGTH\
-   _CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT
+   _CLIAUTH_HASH_MESSAGE_SCHEDULE_LENGTH(_CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT)
+
+/* round constants for 64-bit SHA2, shared with the x86 implementations */
+extern const CliAuthUInt64
+cliauth_hash_sha2_64_constants_rounds [_CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT];
 
 /*----------------------------------------------------------------------------*/
 /* Context struct to be used with SHA2-64 class functions.                    */
@@ -245,17 +404,52 @@ struct CliAuthHashContextSha264 {
    struct _CliAuthHashSha12RingBufferContext ring_context;
 };
 
+/*----------------------------------------------------------------------------*/
+/* State struct to be used with SHA2-64 class functions.                      */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashStateSha264 {
+   CliAuthUInt64 digest [_CLIAUTH_HASH_SHA2_64_DIGEST_WORDS_COUNT];
+   CliAuthUInt64 total;
+};
+
 /*----------------------------------------------------------------------------*/
 /* SHA2-64 class functions.                                                   */
 /*----------------------------------------------------------------------------*/
 /* The type of 'context' should be CliAuthHashContextSha264.                  */
 /*                                                                            */
+/* The type of 'state' should be CliAuthHashStateSha264.                      */
+/*                                                                            */
 /* The length of 'digest' is CLIAUTH_HASH_SHA384_DIGEST_LENGTH,               */
 /* CLIAUTH_HASH_SHA512_DIGEST_LENGTH, CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH,  */
 /* or CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH, depending on the specific        */
 /* algorithm.                                                                 */
 /*----------------------------------------------------------------------------*/
 
+/*----------------------------------------------------------------------------*/
+/* Digests one full input block into each of several independent SHA2-64      */
+/* contexts in lock-step.  This has the same effect as calling 'digest' on    */
+/* each context with _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH bytes, but the blocks */
+/* are compressed in parallel SIMD lanes when the host CPU allows it.  The    */
+/* contexts may belong to any mix of SHA2-64 class algorithms.                */
+/*----------------------------------------------------------------------------*/
+/* contexts - An array of 'count' pointers to initialized contexts of type    */
+/*            CliAuthHashContextSha264.  Each context must have only digested */
+/*            a whole number of input blocks.                                 */
+/*                                                                            */
+/* blocks - An array of 'count' pointers to input blocks of length            */
+/*          _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH, where each block is digested  */
+/*          into the context at the same index.  Multiple entries may point   */
+/*          to the same block.                                                */
+/*                                                                            */
+/* count - The number of entries in 'contexts' and 'blocks'.                  */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_hash_sha2_64_digest_block_multi(
+   void * const contexts [],
+   const void * const blocks [],
+   CliAuthUInt32 count
+);
+
 #if CLIAUTH_CONFIG_HASH_SHA384
 #define CLIAUTH_HASH_SHA384_INPUT_BLOCK_LENGTH _CLIAUTH_HASH_SHA2_64_BLOCK_LENGTH
 #define CLIAUTH_HASH_SHA384_DIGEST_LENGTH 48
@@ -287,6 +481,145 @@ cliauth_hash_sha512_256;
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_HASH_SHA2_64 */
 
+/*----------------------------------------------------------------------------*/
+/* A state struct large enough to store the state of any enabled hash         */
+/* function, for callers which choose the hash function at runtime.           */
+/*----------------------------------------------------------------------------*/
+union CliAuthHashState {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   struct CliAuthHashStateSha1 sha1;
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if _CLIAUTH_HASH_SHA2_32
+   struct CliAuthHashStateSha232 sha2_32;
+#endif /* _CLIAUTH_HASH_SHA2_32 */
+#if _CLIAUTH_HASH_SHA2_64
+   struct CliAuthHashStateSha264 sha2_64;
+#endif /* _CLIAUTH_HASH_SHA2_64 */
+};
+
+/*----------------------------------------------------------------------------*/
+/* The number of lanes in the widest multi-lane compression implementation    */
+/* of any hash function.  Callers of 'digest_block_multi' and                 */
+/* 'digest_finalize_multi' work in groups of up to this many contexts, and a  */
+/* lane manager holds up to this many jobs.                                   */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_HASH_LANES_MAX 8
+
+/*----------------------------------------------------------------------------*/
+/* A single message to be hashed by a lane manager.                           */
+/*----------------------------------------------------------------------------*/
+/* context - An initialized context for the lane manager's hash function.     */
+/*           The context must have only digested a whole number of input      */
+/*           blocks, such as after 'initialize' or 'import_state'.            */
+/*                                                                            */
+/* message - The remaining message bytes to digest.                           */
+/*                                                                            */
+/* digest - A byte buffer to store the final hash value in once the job has   */
+/*          completed.  This may be the same buffer as 'message'.             */
+/*                                                                            */
+/* message_bytes - The number of bytes to read from 'message'.                */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashJob {
+   void * context;
+   const void * message;
+   void * digest;
+   CliAuthUInt32 message_bytes;
+};
+
+/*----------------------------------------------------------------------------*/
+/* A lane manager which packs independent hash jobs of any length into the    */
+/* lanes of a hash function's 'digest_block_multi', and finishes jobs with    */
+/* the same number of bytes left over together with 'digest_finalize_multi'.  */
+/* The fields should be considered private.                                   */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashLanes {
+   /* the hash function all jobs are run with */
+   const struct CliAuthHashFunction * hash_function;
+
+   /* the input block length of the hash function */
+   CliAuthUInt32 block_bytes;
+
+   /* the number of occupied lanes, which are always the first lanes */
+   CliAuthUInt32 lanes_used;
+
+   /* the number of completed jobs waiting to be returned */
+   CliAuthUInt32 completed_count;
+
+   /* the job occupying each lane */
+   struct CliAuthHashJob * jobs [CLIAUTH_HASH_LANES_MAX];
+
+   /* the next full block to digest for each lane */
+   const CliAuthUInt8 * blocks_next [CLIAUTH_HASH_LANES_MAX];
+
+   /* the number of full blocks left to digest for each lane */
+   CliAuthUInt32 blocks_remaining [CLIAUTH_HASH_LANES_MAX];
+
+   /* the completed jobs waiting to be returned */
+   struct CliAuthHashJob * completed [CLIAUTH_HASH_LANES_MAX];
+};
+
+/*----------------------------------------------------------------------------*/
+/* Initializes an empty lane manager.                                         */
+/*----------------------------------------------------------------------------*/
+/* lanes - The lane manager to initialize.                                    */
+/*                                                                            */
+/* hash_function - The hash function to run jobs with.                        */
+/*                                                                            */
+/* block_bytes - The byte length of the hash input blocks.                    */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_hash_lanes_initialize(
+   struct CliAuthHashLanes * lanes,
+   const struct CliAuthHashFunction * hash_function,
+   CliAuthUInt32 block_bytes
+);
+
+/*----------------------------------------------------------------------------*/
+/* Submits a job to a lane manager.  Jobs are only run once every lane is     */
+/* occupied or the lane manager is flushed, and complete in any order.  At    */
+/* most CLIAUTH_HASH_LANES_MAX jobs may be submitted and not yet returned by  */
+/* cliauth_hash_lanes_complete() or cliauth_hash_lanes_flush().  The job and  */
+/* its buffers must remain valid until the job is returned.                   */
+/*----------------------------------------------------------------------------*/
+/* lanes - The lane manager to use.                                           */
+/*                                                                            */
+/* job - The job to submit.                                                   */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_hash_lanes_submit(
+   struct CliAuthHashLanes * lanes,
+   struct CliAuthHashJob * job
+);
+
+/*----------------------------------------------------------------------------*/
+/* Returns a job which has already completed, without running any lanes.      */
+/* This should be called after every submission until it returns null, so     */
+/* completed jobs don't take up room for new ones.                            */
+/*----------------------------------------------------------------------------*/
+/* lanes - The lane manager to use.                                           */
+/*----------------------------------------------------------------------------*/
+/* Return value - A completed job, which may be any previously submitted job, */
+/*                or null if no job has completed yet.                        */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashJob *
+cliauth_hash_lanes_complete(
+   struct CliAuthHashLanes * lanes
+);
+
+/*----------------------------------------------------------------------------*/
+/* Returns a completed job, running the submitted jobs with partially filled  */
+/* lanes if none have completed yet.  This should be called repeatedly until  */
+/* it returns null to complete every submitted job.                           */
+/*----------------------------------------------------------------------------*/
+/* lanes - The lane manager to use.                                           */
+/*----------------------------------------------------------------------------*/
+/* Return value - A completed job, or null if there are no submitted jobs.    */
+/*----------------------------------------------------------------------------*/
+struct CliAuthHashJob *
+cliauth_hash_lanes_flush(
+   struct CliAuthHashLanes * lanes
+);
+
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_HASH_H */
 
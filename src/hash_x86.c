@@ -0,0 +1,776 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/hash_x86.c - x86-accelerated hash compression implementations          */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "hash_x86.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+#include <immintrin.h>
+#include "hash.h"
+
+/* each function is compiled for the extensions it needs, which allows the */
+/* rest of the program to run on CPUs which lack them */
+#define CLIAUTH_HASH_X86_TARGET(features)\
+   __attribute__((target(features)))
+
+#if CLIAUTH_CONFIG_HASH_SHA1
+/*----------------------------------------------------------------------------*/
+
+static CliAuthUInt32
+cliauth_hash_x86_load_big_uint32(const CliAuthUInt8 * bytes) {
+   return
+      ((CliAuthUInt32)bytes[0] << 24) |
+      ((CliAuthUInt32)bytes[1] << 16) |
+      ((CliAuthUInt32)bytes[2] << 8) |
+      ((CliAuthUInt32)bytes[3]);
+}
+
+#define CLIAUTH_HASH_X86_SHA1_K0 0x5a827999
+#define CLIAUTH_HASH_X86_SHA1_K1 0x6ed9eba1
+#define CLIAUTH_HASH_X86_SHA1_K2 0x8f1bbcdc
+#define CLIAUTH_HASH_X86_SHA1_K3 0xca62c1d6
+
+#define CLIAUTH_HASH_X86_SHA1_SCHEDULE_WINDOW 16
+
+#define CLIAUTH_HASH_X86_SSE2_ROTATE_LEFT_32(x, bits)\
+   _mm_or_si128(_mm_slli_epi32((x), (bits)), _mm_srli_epi32((x), 32 - (bits)))
+
+/* ch(b, c, d) = (b & c) ^ (~b & d) */
+#define CLIAUTH_HASH_X86_SSE2_SHA1_CH(b, c, d)\
+   _mm_xor_si128(_mm_and_si128((b), (c)), _mm_andnot_si128((b), (d)))
+
+/* parity(b, c, d) = b ^ c ^ d */
+#define CLIAUTH_HASH_X86_SSE2_SHA1_PARITY(b, c, d)\
+   _mm_xor_si128(_mm_xor_si128((b), (c)), (d))
+
+/* maj(b, c, d) = (b & c) | (d & (b | c)) */
+#define CLIAUTH_HASH_X86_SSE2_SHA1_MAJ(b, c, d)\
+   _mm_or_si128(_mm_and_si128((b), (c)), _mm_and_si128((d), _mm_or_si128((b), (c))))
+
+/* expands the next message schedule word in the 16-word window, 't' must */
+/* be at least 16 */
+#define CLIAUTH_HASH_X86_SSE2_SHA1_SCHEDULE(window, t)\
+   (window[(t) & 15] = CLIAUTH_HASH_X86_SSE2_ROTATE_LEFT_32(\
+      _mm_xor_si128(\
+         _mm_xor_si128(window[((t) - 3) & 15], window[((t) - 8) & 15]),\
+         _mm_xor_si128(window[((t) - 14) & 15], window[(t) & 15])\
+      ),\
+      1\
+   ))
+
+#define CLIAUTH_HASH_X86_SSE2_SHA1_ROUND(function, constant, word)\
+   temp = _mm_add_epi32(\
+      _mm_add_epi32(CLIAUTH_HASH_X86_SSE2_ROTATE_LEFT_32(a, 5), function(b, c, d)),\
+      _mm_add_epi32(_mm_add_epi32(e, constant), (word))\
+   );\
+   e = d;\
+   d = c;\
+   c = CLIAUTH_HASH_X86_SSE2_ROTATE_LEFT_32(b, 30);\
+   b = a;\
+   a = temp;
+
+CLIAUTH_HASH_X86_TARGET("sse2")
+static __m128i
+cliauth_hash_x86_sha1_sse2_load_digest_word(
+   CliAuthUInt32 * const digests [],
+   CliAuthUInt8 word
+) {
+   return _mm_set_epi32(
+      (int)digests[3][word],
+      (int)digests[2][word],
+      (int)digests[1][word],
+      (int)digests[0][word]
+   );
+}
+
+CLIAUTH_HASH_X86_TARGET("sse2")
+static void
+cliauth_hash_x86_sha1_sse2_store_digest_word(
+   CliAuthUInt32 * const digests [],
+   CliAuthUInt8 word,
+   __m128i value
+) {
+   CliAuthUInt32 lanes [CLIAUTH_HASH_X86_SHA1_LANES_SSE2];
+   CliAuthUInt8 i;
+
+   _mm_storeu_si128((__m128i *)lanes, value);
+
+   i = 0;
+   while (i != CLIAUTH_HASH_X86_SHA1_LANES_SSE2) {
+      digests[i][word] += lanes[i];
+      i++;
+   }
+
+   return;
+}
+
+CLIAUTH_HASH_X86_TARGET("sse2")
+void
+cliauth_hash_x86_sha1_digest_blocks_sse2(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+) {
+   __m128i window [CLIAUTH_HASH_X86_SHA1_SCHEDULE_WINDOW];
+   __m128i a, b, c, d, e, temp, k;
+   const CliAuthUInt8 * lanes [CLIAUTH_HASH_X86_SHA1_LANES_SSE2];
+   CliAuthUInt8 t;
+
+   lanes[0] = (const CliAuthUInt8 *)blocks[0];
+   lanes[1] = (const CliAuthUInt8 *)blocks[1];
+   lanes[2] = (const CliAuthUInt8 *)blocks[2];
+   lanes[3] = (const CliAuthUInt8 *)blocks[3];
+
+   /* transpose the big-endian message words so each vector holds the same */
+   /* word from every lane */
+   t = 0;
+   while (t != CLIAUTH_HASH_X86_SHA1_SCHEDULE_WINDOW) {
+      window[t] = _mm_set_epi32(
+         (int)cliauth_hash_x86_load_big_uint32(lanes[3] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[2] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[1] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[0] + (t * 4))
+      );
+      t++;
+   }
+
+   a = cliauth_hash_x86_sha1_sse2_load_digest_word(digests, 0);
+   b = cliauth_hash_x86_sha1_sse2_load_digest_word(digests, 1);
+   c = cliauth_hash_x86_sha1_sse2_load_digest_word(digests, 2);
+   d = cliauth_hash_x86_sha1_sse2_load_digest_word(digests, 3);
+   e = cliauth_hash_x86_sha1_sse2_load_digest_word(digests, 4);
+
+   /* 0 <= t <= 19 */
+   k = _mm_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K0);
+   t = 0;
+   while (t != 16) {
+      CLIAUTH_HASH_X86_SSE2_SHA1_ROUND(CLIAUTH_HASH_X86_SSE2_SHA1_CH, k, window[t]);
+      t++;
+   }
+   while (t != 20) {
+      CLIAUTH_HASH_X86_SSE2_SHA1_ROUND(CLIAUTH_HASH_X86_SSE2_SHA1_CH, k, CLIAUTH_HASH_X86_SSE2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   /* 20 <= t <= 39 */
+   k = _mm_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K1);
+   while (t != 40) {
+      CLIAUTH_HASH_X86_SSE2_SHA1_ROUND(CLIAUTH_HASH_X86_SSE2_SHA1_PARITY, k, CLIAUTH_HASH_X86_SSE2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   /* 40 <= t <= 59 */
+   k = _mm_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K2);
+   while (t != 60) {
+      CLIAUTH_HASH_X86_SSE2_SHA1_ROUND(CLIAUTH_HASH_X86_SSE2_SHA1_MAJ, k, CLIAUTH_HASH_X86_SSE2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   /* 60 <= t <= 79 */
+   k = _mm_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K3);
+   while (t != 80) {
+      CLIAUTH_HASH_X86_SSE2_SHA1_ROUND(CLIAUTH_HASH_X86_SSE2_SHA1_PARITY, k, CLIAUTH_HASH_X86_SSE2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   cliauth_hash_x86_sha1_sse2_store_digest_word(digests, 0, a);
+   cliauth_hash_x86_sha1_sse2_store_digest_word(digests, 1, b);
+   cliauth_hash_x86_sha1_sse2_store_digest_word(digests, 2, c);
+   cliauth_hash_x86_sha1_sse2_store_digest_word(digests, 3, d);
+   cliauth_hash_x86_sha1_sse2_store_digest_word(digests, 4, e);
+
+   return;
+}
+
+#define CLIAUTH_HASH_X86_AVX2_ROTATE_LEFT_32(x, bits)\
+   _mm256_or_si256(_mm256_slli_epi32((x), (bits)), _mm256_srli_epi32((x), 32 - (bits)))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA1_CH(b, c, d)\
+   _mm256_xor_si256(_mm256_and_si256((b), (c)), _mm256_andnot_si256((b), (d)))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA1_PARITY(b, c, d)\
+   _mm256_xor_si256(_mm256_xor_si256((b), (c)), (d))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA1_MAJ(b, c, d)\
+   _mm256_or_si256(_mm256_and_si256((b), (c)), _mm256_and_si256((d), _mm256_or_si256((b), (c))))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA1_SCHEDULE(window, t)\
+   (window[(t) & 15] = CLIAUTH_HASH_X86_AVX2_ROTATE_LEFT_32(\
+      _mm256_xor_si256(\
+         _mm256_xor_si256(window[((t) - 3) & 15], window[((t) - 8) & 15]),\
+         _mm256_xor_si256(window[((t) - 14) & 15], window[(t) & 15])\
+      ),\
+      1\
+   ))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA1_ROUND(function, constant, word)\
+   temp = _mm256_add_epi32(\
+      _mm256_add_epi32(CLIAUTH_HASH_X86_AVX2_ROTATE_LEFT_32(a, 5), function(b, c, d)),\
+      _mm256_add_epi32(_mm256_add_epi32(e, constant), (word))\
+   );\
+   e = d;\
+   d = c;\
+   c = CLIAUTH_HASH_X86_AVX2_ROTATE_LEFT_32(b, 30);\
+   b = a;\
+   a = temp;
+
+CLIAUTH_HASH_X86_TARGET("avx2")
+static __m256i
+cliauth_hash_x86_sha1_avx2_load_digest_word(
+   CliAuthUInt32 * const digests [],
+   CliAuthUInt8 word
+) {
+   return _mm256_set_epi32(
+      (int)digests[7][word],
+      (int)digests[6][word],
+      (int)digests[5][word],
+      (int)digests[4][word],
+      (int)digests[3][word],
+      (int)digests[2][word],
+      (int)digests[1][word],
+      (int)digests[0][word]
+   );
+}
+
+CLIAUTH_HASH_X86_TARGET("avx2")
+static void
+cliauth_hash_x86_sha1_avx2_store_digest_word(
+   CliAuthUInt32 * const digests [],
+   CliAuthUInt8 word,
+   __m256i value
+) {
+   CliAuthUInt32 lanes [CLIAUTH_HASH_X86_SHA1_LANES_AVX2];
+   CliAuthUInt8 i;
+
+   _mm256_storeu_si256((__m256i *)lanes, value);
+
+   i = 0;
+   while (i != CLIAUTH_HASH_X86_SHA1_LANES_AVX2) {
+      digests[i][word] += lanes[i];
+      i++;
+   }
+
+   return;
+}
+
+CLIAUTH_HASH_X86_TARGET("avx2")
+void
+cliauth_hash_x86_sha1_digest_blocks_avx2(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+) {
+   __m256i window [CLIAUTH_HASH_X86_SHA1_SCHEDULE_WINDOW];
+   __m256i a, b, c, d, e, temp, k;
+   const CliAuthUInt8 * lanes [CLIAUTH_HASH_X86_SHA1_LANES_AVX2];
+   CliAuthUInt8 t;
+
+   t = 0;
+   while (t != CLIAUTH_HASH_X86_SHA1_LANES_AVX2) {
+      lanes[t] = (const CliAuthUInt8 *)blocks[t];
+      t++;
+   }
+
+   t = 0;
+   while (t != CLIAUTH_HASH_X86_SHA1_SCHEDULE_WINDOW) {
+      window[t] = _mm256_set_epi32(
+         (int)cliauth_hash_x86_load_big_uint32(lanes[7] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[6] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[5] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[4] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[3] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[2] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[1] + (t * 4)),
+         (int)cliauth_hash_x86_load_big_uint32(lanes[0] + (t * 4))
+      );
+      t++;
+   }
+
+   a = cliauth_hash_x86_sha1_avx2_load_digest_word(digests, 0);
+   b = cliauth_hash_x86_sha1_avx2_load_digest_word(digests, 1);
+   c = cliauth_hash_x86_sha1_avx2_load_digest_word(digests, 2);
+   d = cliauth_hash_x86_sha1_avx2_load_digest_word(digests, 3);
+   e = cliauth_hash_x86_sha1_avx2_load_digest_word(digests, 4);
+
+   /* 0 <= t <= 19 */
+   k = _mm256_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K0);
+   t = 0;
+   while (t != 16) {
+      CLIAUTH_HASH_X86_AVX2_SHA1_ROUND(CLIAUTH_HASH_X86_AVX2_SHA1_CH, k, window[t]);
+      t++;
+   }
+   while (t != 20) {
+      CLIAUTH_HASH_X86_AVX2_SHA1_ROUND(CLIAUTH_HASH_X86_AVX2_SHA1_CH, k, CLIAUTH_HASH_X86_AVX2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   /* 20 <= t <= 39 */
+   k = _mm256_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K1);
+   while (t != 40) {
+      CLIAUTH_HASH_X86_AVX2_SHA1_ROUND(CLIAUTH_HASH_X86_AVX2_SHA1_PARITY, k, CLIAUTH_HASH_X86_AVX2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   /* 40 <= t <= 59 */
+   k = _mm256_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K2);
+   while (t != 60) {
+      CLIAUTH_HASH_X86_AVX2_SHA1_ROUND(CLIAUTH_HASH_X86_AVX2_SHA1_MAJ, k, CLIAUTH_HASH_X86_AVX2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   /* 60 <= t <= 79 */
+   k = _mm256_set1_epi32((int)CLIAUTH_HASH_X86_SHA1_K3);
+   while (t != 80) {
+      CLIAUTH_HASH_X86_AVX2_SHA1_ROUND(CLIAUTH_HASH_X86_AVX2_SHA1_PARITY, k, CLIAUTH_HASH_X86_AVX2_SHA1_SCHEDULE(window, t));
+      t++;
+   }
+
+   cliauth_hash_x86_sha1_avx2_store_digest_word(digests, 0, a);
+   cliauth_hash_x86_sha1_avx2_store_digest_word(digests, 1, b);
+   cliauth_hash_x86_sha1_avx2_store_digest_word(digests, 2, c);
+   cliauth_hash_x86_sha1_avx2_store_digest_word(digests, 3, d);
+   cliauth_hash_x86_sha1_avx2_store_digest_word(digests, 4, e);
+
+   return;
+}
+
+/* performs four SHA-NI rounds for block 'g' of the message while expanding */
+/* the schedule, where 'm_cur' is the message vector for this group and the */
+/* others are the following three vectors in rotating order.  this is only */
+/* valid for 3 <= g <= 16, the first and last groups are written out in */
+/* full since they skip some of the schedule steps. */
+#define CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e_cur, e_next, m_cur, m_next, m_next2, m_prev, function)\
+   e_cur = _mm_sha1nexte_epu32(e_cur, m_cur);\
+   e_next = abcd;\
+   m_next = _mm_sha1msg2_epu32(m_next, m_cur);\
+   abcd = _mm_sha1rnds4_epu32(abcd, e_cur, (function));\
+   m_prev = _mm_sha1msg1_epu32(m_prev, m_cur);\
+   m_next2 = _mm_xor_si128(m_next2, m_cur);
+
+CLIAUTH_HASH_X86_TARGET("sha,sse4.1,ssse3")
+void
+cliauth_hash_x86_sha1_digest_block_sha(
+   CliAuthUInt32 digest [],
+   const void * block
+) {
+   const __m128i * block_iter;
+   __m128i abcd, abcd_save, e0, e0_save, e1, m0, m1, m2, m3, mask;
+
+   block_iter = (const __m128i *)block;
+
+   /* the SHA instructions expect the first word in the highest lane, so */
+   /* the byte order of each 16-byte chunk is fully reversed */
+   mask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+   abcd = _mm_loadu_si128((const __m128i *)digest);
+   abcd = _mm_shuffle_epi32(abcd, 0x1b);
+   e0 = _mm_set_epi32((int)digest[4], 0, 0, 0);
+
+   abcd_save = abcd;
+   e0_save = e0;
+
+   /* rounds 0-3 */
+   m0 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 0), mask);
+   e0 = _mm_add_epi32(e0, m0);
+   e1 = abcd;
+   abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+   /* rounds 4-7 */
+   m1 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 1), mask);
+   e1 = _mm_sha1nexte_epu32(e1, m1);
+   e0 = abcd;
+   abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+   m0 = _mm_sha1msg1_epu32(m0, m1);
+
+   /* rounds 8-11 */
+   m2 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 2), mask);
+   e0 = _mm_sha1nexte_epu32(e0, m2);
+   e1 = abcd;
+   abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+   m1 = _mm_sha1msg1_epu32(m1, m2);
+   m0 = _mm_xor_si128(m0, m2);
+
+   /* rounds 12-67 */
+   m3 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 3), mask);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 0);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 0);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 1);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 1);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 1);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 1);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 1);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 2);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 2);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 2);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m1, m2, m3, m0, 2);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m2, m3, m0, m1, 2);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e1, e0, m3, m0, m1, m2, 3);
+   CLIAUTH_HASH_X86_SHA_SHA1_ROUNDS(e0, e1, m0, m1, m2, m3, 3);
+
+   /* rounds 68-71 */
+   e1 = _mm_sha1nexte_epu32(e1, m1);
+   e0 = abcd;
+   m2 = _mm_sha1msg2_epu32(m2, m1);
+   abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+   m3 = _mm_xor_si128(m3, m1);
+
+   /* rounds 72-75 */
+   e0 = _mm_sha1nexte_epu32(e0, m2);
+   e1 = abcd;
+   m3 = _mm_sha1msg2_epu32(m3, m2);
+   abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+   /* rounds 76-79 */
+   e1 = _mm_sha1nexte_epu32(e1, m3);
+   e0 = abcd;
+   abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+   /* add the working variables back into the digest */
+   e0 = _mm_sha1nexte_epu32(e0, e0_save);
+   abcd = _mm_add_epi32(abcd, abcd_save);
+
+   abcd = _mm_shuffle_epi32(abcd, 0x1b);
+   _mm_storeu_si128((__m128i *)digest, abcd);
+   digest[4] = (CliAuthUInt32)_mm_extract_epi32(e0, 3);
+
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+
+#if _CLIAUTH_HASH_SHA2_32
+/*----------------------------------------------------------------------------*/
+
+/* performs two SHA-NI double-rounds for message group 'g' */
+#define CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(g, m_cur)\
+   message = _mm_add_epi32((m_cur), _mm_loadu_si128(constants + (g)));\
+   state1 = _mm_sha256rnds2_epu32(state1, state0, message);\
+   message = _mm_shuffle_epi32(message, 0x0e);\
+   state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+
+/* finishes expanding the message vector 'm_next' using the current and */
+/* previous message vectors */
+#define CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m_cur, m_prev, m_next)\
+   m_next = _mm_add_epi32(m_next, _mm_alignr_epi8((m_cur), (m_prev), 4));\
+   m_next = _mm_sha256msg2_epu32(m_next, (m_cur));
+
+/* begins expanding the message vector 'm_later' */
+#define CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m_cur, m_later)\
+   m_later = _mm_sha256msg1_epu32(m_later, (m_cur));
+
+CLIAUTH_HASH_X86_TARGET("sha,sse4.1,ssse3")
+void
+cliauth_hash_x86_sha2_32_digest_block_sha(
+   CliAuthUInt32 digest [],
+   const void * block
+) {
+   const __m128i * block_iter;
+   const __m128i * constants;
+   __m128i state0, state1, state0_save, state1_save, temp, message;
+   __m128i m0, m1, m2, m3, mask;
+
+   block_iter = (const __m128i *)block;
+   constants = (const __m128i *)cliauth_hash_sha2_32_constants_rounds;
+
+   /* byte-swaps each 32-bit word */
+   mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+   /* the SHA instructions operate on the state as ABEF and CDGH */
+   temp = _mm_loadu_si128((const __m128i *)(digest + 0));
+   state1 = _mm_loadu_si128((const __m128i *)(digest + 4));
+   temp = _mm_shuffle_epi32(temp, 0xb1);
+   state1 = _mm_shuffle_epi32(state1, 0x1b);
+   state0 = _mm_alignr_epi8(temp, state1, 8);
+   state1 = _mm_blend_epi16(state1, temp, 0xf0);
+
+   state0_save = state0;
+   state1_save = state1;
+
+   /* rounds 0-15 */
+   m0 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 0), mask);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(0, m0);
+
+   m1 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 1), mask);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(1, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m1, m0);
+
+   m2 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 2), mask);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(2, m2);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m2, m1);
+
+   m3 = _mm_shuffle_epi8(_mm_loadu_si128(block_iter + 3), mask);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(3, m3);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m3, m2, m0);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m3, m2);
+
+   /* rounds 16-51 */
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(4, m0);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m0, m3, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m0, m3);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(5, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m1, m0, m2);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m1, m0);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(6, m2);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m2, m1, m3);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m2, m1);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(7, m3);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m3, m2, m0);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m3, m2);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(8, m0);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m0, m3, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m0, m3);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(9, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m1, m0, m2);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m1, m0);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(10, m2);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m2, m1, m3);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m2, m1);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(11, m3);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m3, m2, m0);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m3, m2);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(12, m0);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m0, m3, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_1(m0, m3);
+
+   /* rounds 52-63 */
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(13, m1);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m1, m0, m2);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(14, m2);
+   CLIAUTH_HASH_X86_SHA_SHA2_32_SCHEDULE_2(m2, m1, m3);
+
+   CLIAUTH_HASH_X86_SHA_SHA2_32_ROUNDS(15, m3);
+
+   /* add the working variables back into the digest */
+   state0 = _mm_add_epi32(state0, state0_save);
+   state1 = _mm_add_epi32(state1, state1_save);
+
+   temp = _mm_shuffle_epi32(state0, 0x1b);
+   state1 = _mm_shuffle_epi32(state1, 0xb1);
+   state0 = _mm_blend_epi16(temp, state1, 0xf0);
+   state1 = _mm_alignr_epi8(state1, temp, 8);
+
+   _mm_storeu_si128((__m128i *)(digest + 0), state0);
+   _mm_storeu_si128((__m128i *)(digest + 4), state1);
+
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_HASH_SHA2_32 */
+
+#if _CLIAUTH_HASH_SHA2_64
+/*----------------------------------------------------------------------------*/
+
+#define CLIAUTH_HASH_X86_SHA2_64_SCHEDULE_WINDOW 16
+
+static CliAuthUInt64
+cliauth_hash_x86_load_big_uint64(const CliAuthUInt8 * bytes) {
+   return
+      ((CliAuthUInt64)bytes[0] << 56) |
+      ((CliAuthUInt64)bytes[1] << 48) |
+      ((CliAuthUInt64)bytes[2] << 40) |
+      ((CliAuthUInt64)bytes[3] << 32) |
+      ((CliAuthUInt64)bytes[4] << 24) |
+      ((CliAuthUInt64)bytes[5] << 16) |
+      ((CliAuthUInt64)bytes[6] << 8) |
+      ((CliAuthUInt64)bytes[7]);
+}
+
+#define CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64(x, bits)\
+   _mm256_or_si256(_mm256_srli_epi64((x), (bits)), _mm256_slli_epi64((x), 64 - (bits)))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_CH(e, f, g)\
+   _mm256_xor_si256(_mm256_and_si256((e), (f)), _mm256_andnot_si256((e), (g)))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_MAJ(a, b, c)\
+   _mm256_or_si256(_mm256_and_si256((a), (b)), _mm256_and_si256((c), _mm256_or_si256((a), (b))))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_U0(x)\
+   _mm256_xor_si256(\
+      _mm256_xor_si256(\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 28),\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 34)\
+      ),\
+      CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 39)\
+   )
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_U1(x)\
+   _mm256_xor_si256(\
+      _mm256_xor_si256(\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 14),\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 18)\
+      ),\
+      CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 41)\
+   )
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_L0(x)\
+   _mm256_xor_si256(\
+      _mm256_xor_si256(\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 1),\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 8)\
+      ),\
+      _mm256_srli_epi64((x), 7)\
+   )
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_L1(x)\
+   _mm256_xor_si256(\
+      _mm256_xor_si256(\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 19),\
+         CLIAUTH_HASH_X86_AVX2_ROTATE_RIGHT_64((x), 61)\
+      ),\
+      _mm256_srli_epi64((x), 6)\
+   )
+
+/* expands the next message schedule word in the 16-word window, 't' must */
+/* be at least 16 */
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_SCHEDULE(window, t)\
+   (window[(t) & 15] = _mm256_add_epi64(\
+      _mm256_add_epi64(\
+         CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_L1(window[((t) - 2) & 15]),\
+         window[((t) - 7) & 15]\
+      ),\
+      _mm256_add_epi64(\
+         CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_L0(window[((t) - 15) & 15]),\
+         window[(t) & 15]\
+      )\
+   ))
+
+#define CLIAUTH_HASH_X86_AVX2_SHA2_64_ROUND(t, word)\
+   temp1 = _mm256_add_epi64(\
+      _mm256_add_epi64(\
+         _mm256_add_epi64(h, CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_U1(e)),\
+         CLIAUTH_HASH_X86_AVX2_SHA2_64_CH(e, f, g)\
+      ),\
+      _mm256_add_epi64(\
+         _mm256_set1_epi64x((CliAuthSInt64)cliauth_hash_sha2_64_constants_rounds[(t)]),\
+         (word)\
+      )\
+   );\
+   temp2 = _mm256_add_epi64(\
+      CLIAUTH_HASH_X86_AVX2_SHA2_64_SIGMA_U0(a),\
+      CLIAUTH_HASH_X86_AVX2_SHA2_64_MAJ(a, b, c)\
+   );\
+   h = g;\
+   g = f;\
+   f = e;\
+   e = _mm256_add_epi64(d, temp1);\
+   d = c;\
+   c = b;\
+   b = a;\
+   a = _mm256_add_epi64(temp1, temp2);
+
+CLIAUTH_HASH_X86_TARGET("avx2")
+static __m256i
+cliauth_hash_x86_sha2_64_avx2_load_digest_word(
+   CliAuthUInt64 * const digests [],
+   CliAuthUInt8 word
+) {
+   return _mm256_set_epi64x(
+      (CliAuthSInt64)digests[3][word],
+      (CliAuthSInt64)digests[2][word],
+      (CliAuthSInt64)digests[1][word],
+      (CliAuthSInt64)digests[0][word]
+   );
+}
+
+CLIAUTH_HASH_X86_TARGET("avx2")
+static void
+cliauth_hash_x86_sha2_64_avx2_store_digest_word(
+   CliAuthUInt64 * const digests [],
+   CliAuthUInt8 word,
+   __m256i value
+) {
+   CliAuthUInt64 lanes [CLIAUTH_HASH_X86_SHA2_64_LANES_AVX2];
+   CliAuthUInt8 i;
+
+   _mm256_storeu_si256((__m256i *)lanes, value);
+
+   i = 0;
+   while (i != CLIAUTH_HASH_X86_SHA2_64_LANES_AVX2) {
+      digests[i][word] += lanes[i];
+      i++;
+   }
+
+   return;
+}
+
+CLIAUTH_HASH_X86_TARGET("avx2")
+void
+cliauth_hash_x86_sha2_64_digest_blocks_avx2(
+   CliAuthUInt64 * const digests [],
+   const void * const blocks []
+) {
+   __m256i window [CLIAUTH_HASH_X86_SHA2_64_SCHEDULE_WINDOW];
+   __m256i a, b, c, d, e, f, g, h, temp1, temp2;
+   const CliAuthUInt8 * lanes [CLIAUTH_HASH_X86_SHA2_64_LANES_AVX2];
+   CliAuthUInt8 t;
+
+   lanes[0] = (const CliAuthUInt8 *)blocks[0];
+   lanes[1] = (const CliAuthUInt8 *)blocks[1];
+   lanes[2] = (const CliAuthUInt8 *)blocks[2];
+   lanes[3] = (const CliAuthUInt8 *)blocks[3];
+
+   /* transpose the big-endian message words so each vector holds the same */
+   /* word from every lane */
+   t = 0;
+   while (t != CLIAUTH_HASH_X86_SHA2_64_SCHEDULE_WINDOW) {
+      window[t] = _mm256_set_epi64x(
+         (CliAuthSInt64)cliauth_hash_x86_load_big_uint64(lanes[3] + (t * 8)),
+         (CliAuthSInt64)cliauth_hash_x86_load_big_uint64(lanes[2] + (t * 8)),
+         (CliAuthSInt64)cliauth_hash_x86_load_big_uint64(lanes[1] + (t * 8)),
+         (CliAuthSInt64)cliauth_hash_x86_load_big_uint64(lanes[0] + (t * 8))
+      );
+      t++;
+   }
+
+   a = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 0);
+   b = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 1);
+   c = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 2);
+   d = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 3);
+   e = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 4);
+   f = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 5);
+   g = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 6);
+   h = cliauth_hash_x86_sha2_64_avx2_load_digest_word(digests, 7);
+
+   t = 0;
+   while (t != 16) {
+      CLIAUTH_HASH_X86_AVX2_SHA2_64_ROUND(t, window[t]);
+      t++;
+   }
+   while (t != _CLIAUTH_HASH_SHA2_64_ROUNDS_COUNT) {
+      CLIAUTH_HASH_X86_AVX2_SHA2_64_ROUND(t, CLIAUTH_HASH_X86_AVX2_SHA2_64_SCHEDULE(window, t));
+      t++;
+   }
+
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 0, a);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 1, b);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 2, c);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 3, d);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 4, e);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 5, f);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 6, g);
+   cliauth_hash_x86_sha2_64_avx2_store_digest_word(digests, 7, h);
+
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_HASH_SHA2_64 */
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
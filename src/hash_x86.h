@@ -0,0 +1,95 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/hash_x86.h - Header for x86-accelerated hash compression functions     */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_HASH_X86_H
+#define _CLIAUTH_HASH_X86_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "hash.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* The functions in this header are the raw block compression functions used  */
+/* internally by the hash implementations.  Each one requires the CPU         */
+/* features listed in its name, which must be verified with                   */
+/* cliauth_cpu_x86_features() before calling it.                              */
+/*                                                                            */
+/* Digests are stored as arrays of words in the host's native endianess, in   */
+/* the same layout as the 'digest' field of the hash context structs.  Blocks */
+/* are full input blocks of raw message bytes.                                */
+/*                                                                            */
+/* For the multi-lane functions, each lane is an independent hash state, and  */
+/* one block is compressed into every lane at once.  'digests' and 'blocks'   */
+/* must contain exactly as many entries as the function has lanes.  Entries   */
+/* of 'blocks' are allowed to point to the same memory.                       */
+/*                                                                            */
+/* The single-block SHA extension functions additionally require SSSE3 and    */
+/* SSE4.1, which every CPU with the SHA extensions supports.                  */
+/*----------------------------------------------------------------------------*/
+
+#if CLIAUTH_CONFIG_HASH_SHA1
+/*----------------------------------------------------------------------------*/
+
+#define CLIAUTH_HASH_X86_SHA1_LANES_SSE2 4
+#define CLIAUTH_HASH_X86_SHA1_LANES_AVX2 8
+
+void
+cliauth_hash_x86_sha1_digest_blocks_sse2(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+);
+
+void
+cliauth_hash_x86_sha1_digest_blocks_avx2(
+   CliAuthUInt32 * const digests [],
+   const void * const blocks []
+);
+
+void
+cliauth_hash_x86_sha1_digest_block_sha(
+   CliAuthUInt32 digest [],
+   const void * block
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+
+#if _CLIAUTH_HASH_SHA2_32
+/*----------------------------------------------------------------------------*/
+
+void
+cliauth_hash_x86_sha2_32_digest_block_sha(
+   CliAuthUInt32 digest [],
+   const void * block
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_HASH_SHA2_32 */
+
+#if _CLIAUTH_HASH_SHA2_64
+/*----------------------------------------------------------------------------*/
+
+#define CLIAUTH_HASH_X86_SHA2_64_LANES_AVX2 4
+
+void
+cliauth_hash_x86_sha2_64_digest_blocks_avx2(
+   CliAuthUInt64 * const digests [],
+   const void * const blocks []
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_HASH_SHA2_64 */
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_HASH_X86_H */
+
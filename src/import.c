@@ -0,0 +1,541 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/import.c - Bulk key URI importer implementation.                       */
+/*----------------------------------------------------------------------------*/
+
+/* required for the POSIX file and memory mapping functions in strict C89 */
+/* mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include "cliauth.h"
+#include "import.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* HAVE_MMAP */
+
+/* only defined when threads are enabled, but always passed around so the */
+/* file importers can be shared */
+struct CliAuthImportWorkers;
+
+/* finds the line at the start of 'text', returning its length without the */
+/* line ending.  'consumed' is set to the number of characters to skip over */
+/* to reach the next line. */
+static CliAuthUInt64
+cliauth_import_next_line(
+   const char text [],
+   CliAuthUInt64 text_characters,
+   CliAuthUInt64 * consumed
+) {
+   const char * newline;
+   CliAuthUInt64 line_characters;
+
+   newline = (const char *)memchr(text, '\n', (size_t)text_characters);
+
+   if (newline == CLIAUTH_NULLPTR) {
+      line_characters = text_characters;
+      *consumed = text_characters;
+   } else {
+      line_characters = (CliAuthUInt64)(newline - text);
+      *consumed = line_characters + 1;
+   }
+
+   if (line_characters != 0 && text[line_characters - 1] == '\r') {
+      line_characters--;
+   }
+
+   return line_characters;
+}
+
+static enum CliAuthParseKeyUriResult
+cliauth_import_parse_line(
+   struct CliAuthParseKeyUriPayload * payload,
+   const char text [],
+   CliAuthUInt64 text_characters
+) {
+   /* a line this long can't be a valid key URI, and will fail to parse */
+   /* either way */
+   if (text_characters > CLIAUTH_UINT32_MAX) {
+      text_characters = CLIAUTH_UINT32_MAX;
+   }
+
+   return cliauth_parse_key_uri(
+      payload,
+      text,
+      (CliAuthUInt32)text_characters
+   );
+}
+
+CliAuthUInt64
+cliauth_import_text(
+   const char text [],
+   CliAuthUInt64 text_characters,
+   CliAuthUInt64 line_first,
+   CliAuthImportFunction function,
+   void * context
+) {
+   struct CliAuthParseKeyUriPayload payload;
+   enum CliAuthParseKeyUriResult result;
+   const char * text_iter;
+   CliAuthUInt64 line, line_characters, line_consumed;
+
+   text_iter = text;
+   line = line_first;
+
+   while (text_characters != 0) {
+      line_characters = cliauth_import_next_line(
+         text_iter,
+         text_characters,
+         &line_consumed
+      );
+
+      if (line_characters != 0) {
+         result = cliauth_import_parse_line(
+            &payload,
+            text_iter,
+            line_characters
+         );
+
+         function(context, &payload, result, line);
+      }
+
+      text_iter += line_consumed;
+      text_characters -= line_consumed;
+      line++;
+   }
+
+   return line - line_first;
+}
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+/* parses the lines of a chunk into its entries, stopping early if they run */
+/* out.  line numbers are relative to the start of the chunk, since the */
+/* number of lines in earlier chunks isn't known yet. */
+static void
+cliauth_import_parse_chunk(
+   struct CliAuthImportChunk * chunk
+) {
+   struct CliAuthImportEntry * entry;
+   const char * text_iter;
+   CliAuthUInt64 text_characters, line_characters, line_consumed;
+   CliAuthBoolean full;
+
+   text_iter = chunk->text;
+   text_characters = chunk->text_characters;
+   chunk->lines = 0;
+   chunk->entries_count = 0;
+   full = CLIAUTH_BOOLEAN_FALSE;
+
+   while (text_characters != 0 && full == CLIAUTH_BOOLEAN_FALSE) {
+      line_characters = cliauth_import_next_line(
+         text_iter,
+         text_characters,
+         &line_consumed
+      );
+
+      if (line_characters != 0 && chunk->entries_count == CLIAUTH_IMPORT_CHUNK_ENTRIES) {
+         full = CLIAUTH_BOOLEAN_TRUE;
+      } else {
+         if (line_characters != 0) {
+            entry = &chunk->entries[chunk->entries_count];
+            entry->result = cliauth_import_parse_line(
+               &entry->payload,
+               text_iter,
+               line_characters
+            );
+            entry->line = chunk->lines;
+            chunk->entries_count++;
+         }
+
+         text_iter += line_consumed;
+         text_characters -= line_consumed;
+         chunk->lines++;
+      }
+   }
+
+   chunk->text_parsed = chunk->text_characters - text_characters;
+   return;
+}
+
+static void
+cliauth_import_parse_chunks(
+   void * chunks_generic,
+   struct CliAuthOtpBuffersGeneric buffers [],
+   CliAuthUInt64 index_first,
+   CliAuthUInt64 index_count
+) {
+   struct CliAuthImportChunk * chunks;
+
+   (void)buffers;
+
+   chunks = (struct CliAuthImportChunk *)chunks_generic;
+
+   while (index_count != 0) {
+      cliauth_import_parse_chunk(&chunks[index_first]);
+      index_first++;
+      index_count--;
+   }
+
+   return;
+}
+
+CliAuthUInt64
+cliauth_import_text_parallel(
+   const struct CliAuthImportWorkers * workers,
+   const char text [],
+   CliAuthUInt64 text_characters,
+   CliAuthUInt64 line_first,
+   CliAuthImportFunction function,
+   void * context
+) {
+   struct CliAuthImportChunk * chunk;
+   const struct CliAuthImportEntry * entry;
+   const char * newline;
+   CliAuthUInt64 line, offset, offset_end;
+   CliAuthUInt32 chunks_count, i, j;
+
+   line = line_first;
+   offset = 0;
+
+   while (offset != text_characters) {
+      /* split off as many chunks as there is room for, each ending just */
+      /* after a newline so no line is split between two chunks */
+      chunks_count = 0;
+      while (chunks_count != workers->chunks_count && offset != text_characters) {
+         offset_end = text_characters;
+         if (text_characters - offset > CLIAUTH_IMPORT_CHUNK_CHARACTERS) {
+            offset_end = offset + CLIAUTH_IMPORT_CHUNK_CHARACTERS;
+
+            newline = (const char *)memchr(
+               &text[offset_end - 1],
+               '\n',
+               (size_t)(text_characters - (offset_end - 1))
+            );
+
+            offset_end = text_characters;
+            if (newline != CLIAUTH_NULLPTR) {
+               offset_end = (CliAuthUInt64)(newline - text) + 1;
+            }
+         }
+
+         chunk = &workers->chunks[chunks_count];
+         chunk->text = &text[offset];
+         chunk->text_characters = offset_end - offset;
+
+         offset = offset_end;
+         chunks_count++;
+      }
+
+      cliauth_pool_run(
+         workers->pool,
+         cliauth_import_parse_chunks,
+         workers->chunks,
+         chunks_count,
+         1
+      );
+
+      /* hand out the results in their original order, now that the number */
+      /* of lines before each chunk is known */
+      i = 0;
+      while (i != chunks_count) {
+         chunk = &workers->chunks[i];
+
+         j = 0;
+         while (j != chunk->entries_count) {
+            entry = &chunk->entries[j];
+            function(context, &entry->payload, entry->result, line + entry->line);
+            j++;
+         }
+
+         if (chunk->text_parsed != chunk->text_characters) {
+            chunk->lines += cliauth_import_text(
+               &chunk->text[chunk->text_parsed],
+               chunk->text_characters - chunk->text_parsed,
+               line + chunk->lines,
+               function,
+               context
+            );
+         }
+
+         line += chunk->lines;
+         i++;
+      }
+   }
+
+   return line - line_first;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+#ifdef HAVE_MMAP
+/*----------------------------------------------------------------------------*/
+
+/* imports text with the parallel importer when there are workers to import */
+/* with, otherwise on the calling thread */
+static CliAuthUInt64
+cliauth_import_text_generic(
+   const struct CliAuthImportWorkers * workers,
+   const char text [],
+   CliAuthUInt64 text_characters,
+   CliAuthImportFunction function,
+   void * context
+) {
+#if CLIAUTH_CONFIG_THREADS
+   if (workers != CLIAUTH_NULLPTR) {
+      return cliauth_import_text_parallel(
+         workers,
+         text,
+         text_characters,
+         1,
+         function,
+         context
+      );
+   }
+#else /* CLIAUTH_CONFIG_THREADS */
+   (void)workers;
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   return cliauth_import_text(text, text_characters, 1, function, context);
+}
+
+/* imports a file by mapping it into memory.  'mapped' is set to false if the */
+/* file can't be mapped, such as for pipes, in which case nothing is imported */
+static enum CliAuthImportResult
+cliauth_import_file_mapped(
+   const struct CliAuthImportWorkers * workers,
+   int descriptor,
+   CliAuthBoolean * mapped,
+   CliAuthImportFunction function,
+   void * context
+) {
+   struct stat status;
+   void * mapping;
+   size_t mapping_bytes;
+
+   *mapped = CLIAUTH_BOOLEAN_FALSE;
+
+   if (fstat(descriptor, &status) != 0 || S_ISREG(status.st_mode) == 0) {
+      return CLIAUTH_IMPORT_RESULT_SUCCESS;
+   }
+
+   *mapped = CLIAUTH_BOOLEAN_TRUE;
+
+   /* zero-length mappings aren't allowed */
+   if (status.st_size == 0) {
+      return CLIAUTH_IMPORT_RESULT_SUCCESS;
+   }
+
+   mapping_bytes = (size_t)status.st_size;
+
+   mapping = mmap(
+      CLIAUTH_NULLPTR,
+      mapping_bytes,
+      PROT_READ,
+      MAP_PRIVATE,
+      descriptor,
+      0
+   );
+   if (mapping == MAP_FAILED) {
+      *mapped = CLIAUTH_BOOLEAN_FALSE;
+      return CLIAUTH_IMPORT_RESULT_SUCCESS;
+   }
+
+   /* the file is read front to back exactly once */
+   (void)posix_madvise(mapping, mapping_bytes, POSIX_MADV_SEQUENTIAL);
+
+   (void)cliauth_import_text_generic(
+      workers,
+      (const char *)mapping,
+      mapping_bytes,
+      function,
+      context
+   );
+
+   (void)munmap(mapping, mapping_bytes);
+
+   return CLIAUTH_IMPORT_RESULT_SUCCESS;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* HAVE_MMAP */
+
+/* the size of the buffer used when a file can't be mapped, which fits the */
+/* longest key URI the parser accepts along with a CRLF line ending.  lines */
+/* which don't fit are reported as too long without being parsed, exactly as */
+/* the parser would report them. */
+#define _CLIAUTH_IMPORT_BUFFER_CHARACTERS\
+   (CLIAUTH_PARSE_KEY_URI_MAX_LENGTH + 2)
+
+/* imports a file by reading it through a fixed-size buffer, only ever */
+/* parsing complete lines */
+static enum CliAuthImportResult
+cliauth_import_file_streamed(
+   FILE * file,
+   CliAuthImportFunction function,
+   void * context
+) {
+   char buffer [_CLIAUTH_IMPORT_BUFFER_CHARACTERS];
+   CliAuthUInt64 line;
+   size_t buffered, complete, read;
+   CliAuthBoolean skipping;
+
+   line = 1;
+   buffered = 0;
+   skipping = CLIAUTH_BOOLEAN_FALSE;
+
+   do {
+      read = fread(
+         &buffer[buffered],
+         1,
+         _CLIAUTH_IMPORT_BUFFER_CHARACTERS - buffered,
+         file
+      );
+      buffered += read;
+
+      /* drop the rest of a line which didn't fit in the buffer */
+      if (skipping == CLIAUTH_BOOLEAN_TRUE) {
+         complete = 0;
+         while (complete != buffered && buffer[complete] != '\n') {
+            complete++;
+         }
+
+         if (complete != buffered) {
+            complete++;
+            line++;
+            skipping = CLIAUTH_BOOLEAN_FALSE;
+         }
+
+         buffered -= complete;
+         (void)memmove(buffer, &buffer[complete], buffered);
+      }
+
+      /* parse every line up to and including the last newline */
+      complete = buffered;
+      while (complete != 0 && buffer[complete - 1] != '\n') {
+         complete--;
+      }
+
+      if (complete != 0) {
+         line += cliauth_import_text(buffer, complete, line, function, context);
+
+         buffered -= complete;
+         (void)memmove(buffer, &buffer[complete], buffered);
+      }
+
+      if (buffered == _CLIAUTH_IMPORT_BUFFER_CHARACTERS) {
+         function(
+            context,
+            CLIAUTH_NULLPTR,
+            CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_URI,
+            line
+         );
+
+         buffered = 0;
+         skipping = CLIAUTH_BOOLEAN_TRUE;
+      }
+   } while (read != 0);
+
+   if (ferror(file) != 0) {
+      return CLIAUTH_IMPORT_RESULT_READ_FAILED;
+   }
+
+   /* the final line doesn't need to end with a newline */
+   if (skipping == CLIAUTH_BOOLEAN_FALSE) {
+      (void)cliauth_import_text(buffer, buffered, line, function, context);
+   }
+
+   return CLIAUTH_IMPORT_RESULT_SUCCESS;
+}
+
+static enum CliAuthImportResult
+cliauth_import_file_generic(
+   const struct CliAuthImportWorkers * workers,
+   const char path [],
+   CliAuthImportFunction function,
+   void * context
+) {
+   enum CliAuthImportResult result;
+   FILE * file;
+#ifdef HAVE_MMAP
+   CliAuthBoolean mapped;
+   int descriptor;
+
+   descriptor = open(path, O_RDONLY);
+   if (descriptor < 0) {
+      return CLIAUTH_IMPORT_RESULT_OPEN_FAILED;
+   }
+
+   result = cliauth_import_file_mapped(
+      workers,
+      descriptor,
+      &mapped,
+      function,
+      context
+   );
+
+   (void)close(descriptor);
+
+   if (mapped == CLIAUTH_BOOLEAN_TRUE) {
+      return result;
+   }
+#else /* HAVE_MMAP */
+   (void)workers;
+#endif /* HAVE_MMAP */
+
+   file = fopen(path, "rb");
+   if (file == CLIAUTH_NULLPTR) {
+      return CLIAUTH_IMPORT_RESULT_OPEN_FAILED;
+   }
+
+   result = cliauth_import_file_streamed(file, function, context);
+
+   (void)fclose(file);
+
+   return result;
+}
+
+enum CliAuthImportResult
+cliauth_import_file(
+   const char path [],
+   CliAuthImportFunction function,
+   void * context
+) {
+   return cliauth_import_file_generic(
+      CLIAUTH_NULLPTR,
+      path,
+      function,
+      context
+   );
+}
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+enum CliAuthImportResult
+cliauth_import_file_parallel(
+   const struct CliAuthImportWorkers * workers,
+   const char path [],
+   CliAuthImportFunction function,
+   void * context
+) {
+   return cliauth_import_file_generic(
+      workers,
+      path,
+      function,
+      context
+   );
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
@@ -0,0 +1,208 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/import.h - Bulk key URI importer header.                               */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_IMPORT_H
+#define _CLIAUTH_IMPORT_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "parse.h"
+#include "pool.h"
+
+/*----------------------------------------------------------------------------*/
+/* Receives the result of parsing a single line of imported key URIs.         */
+/*----------------------------------------------------------------------------*/
+/* context - The pointer given to the import function.                        */
+/*                                                                            */
+/* payload - The parsed key URI.  This is only valid if 'result' is           */
+/*           'CLIAUTH_PARSE_KEY_URI_RESULT_SUCCESS', and only until the       */
+/*           function returns, so anything needed later must be copied.       */
+/*                                                                            */
+/* result - The result of parsing the line with cliauth_parse_key_uri().      */
+/*                                                                            */
+/* line - The line number of the key URI in the input, starting from 1.       */
+/*----------------------------------------------------------------------------*/
+typedef void (*CliAuthImportFunction)(
+   void * context,
+   const struct CliAuthParseKeyUriPayload * payload,
+   enum CliAuthParseKeyUriResult result,
+   CliAuthUInt64 line
+);
+
+/*----------------------------------------------------------------------------*/
+/* Return status enum for cliauth_import_file().                              */
+/*----------------------------------------------------------------------------*/
+/* CLIAUTH_IMPORT_RESULT_SUCCESS - The entire file was read.  This says       */
+/*                                 nothing about whether the individual key   */
+/*                                 URIs were valid.                           */
+/*                                                                            */
+/* CLIAUTH_IMPORT_RESULT_OPEN_FAILED - The file couldn't be opened.           */
+/*                                                                            */
+/* CLIAUTH_IMPORT_RESULT_READ_FAILED - The file couldn't be read completely.  */
+/*                                     Any lines before the failure have      */
+/*                                     already been passed to the callback.   */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_IMPORT_RESULT_FIELD_COUNT 3
+enum CliAuthImportResult {
+   CLIAUTH_IMPORT_RESULT_SUCCESS,
+   CLIAUTH_IMPORT_RESULT_OPEN_FAILED,
+   CLIAUTH_IMPORT_RESULT_READ_FAILED
+};
+
+/*----------------------------------------------------------------------------*/
+/* Parses newline-delimited key URIs from memory, passing every line to a     */
+/* callback in order.  Each line is parsed in place without being copied.     */
+/* A carriage return before a newline is ignored, and empty lines are         */
+/* skipped, but still counted for line numbers.                               */
+/*----------------------------------------------------------------------------*/
+/* text - The key URIs to parse.  The text does not have to end with a        */
+/*        newline or be null-terminated.                                      */
+/*                                                                            */
+/* text_characters - The length of 'text' in characters.                      */
+/*                                                                            */
+/* line_first - The line number of the first line of 'text', which allows     */
+/*              callers to split up a larger input.                           */
+/*                                                                            */
+/* function - The function to call for every non-empty line.                  */
+/*                                                                            */
+/* context - Passed as-is to 'function'.                                      */
+/*----------------------------------------------------------------------------*/
+/* Return value - The number of lines in 'text', including empty lines.       */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt64
+cliauth_import_text(
+   const char text [],
+   CliAuthUInt64 text_characters,
+   CliAuthUInt64 line_first,
+   CliAuthImportFunction function,
+   void * context
+);
+
+/*----------------------------------------------------------------------------*/
+/* Parses a file of newline-delimited key URIs, passing every line to a       */
+/* callback in order, with the same rules as cliauth_import_text().  If       */
+/* possible, the file is memory-mapped and parsed in place.  Otherwise, it is */
+/* streamed through a fixed-size buffer, so memory use doesn't grow with the  */
+/* size of the file either way.                                               */
+/*----------------------------------------------------------------------------*/
+/* path - The null-terminated path of the file to import.                     */
+/*                                                                            */
+/* function - The function to call for every non-empty line.                  */
+/*                                                                            */
+/* context - Passed as-is to 'function'.                                      */
+/*----------------------------------------------------------------------------*/
+/* Return value - The status of reading the file.                             */
+/*----------------------------------------------------------------------------*/
+enum CliAuthImportResult
+cliauth_import_file(
+   const char path [],
+   CliAuthImportFunction function,
+   void * context
+);
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* The number of characters of input parsed by a single chunk, which is       */
+/* extended to the end of the line it stops in.                               */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_IMPORT_CHUNK_CHARACTERS 16384
+
+/*----------------------------------------------------------------------------*/
+/* The number of parsed lines a chunk can hold.  Any lines of a chunk which   */
+/* don't fit are parsed afterwards on the calling thread instead.             */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_IMPORT_CHUNK_ENTRIES 256
+
+/*----------------------------------------------------------------------------*/
+/* A single parsed line.  The members should be treated as private.           */
+/*----------------------------------------------------------------------------*/
+struct CliAuthImportEntry {
+   struct CliAuthParseKeyUriPayload payload;
+   enum CliAuthParseKeyUriResult result;
+   CliAuthUInt64 line;
+};
+
+/*----------------------------------------------------------------------------*/
+/* A piece of the input parsed by a single worker, along with the parsed      */
+/* lines waiting to be passed to the callback.  The members should be treated */
+/* as private.                                                                */
+/*----------------------------------------------------------------------------*/
+struct CliAuthImportChunk {
+   struct CliAuthImportEntry entries [CLIAUTH_IMPORT_CHUNK_ENTRIES];
+   const char * text;
+   CliAuthUInt64 text_characters;
+   CliAuthUInt64 text_parsed;
+   CliAuthUInt64 lines;
+   CliAuthUInt32 entries_count;
+};
+
+/*----------------------------------------------------------------------------*/
+/* The resources used to import key URIs in parallel.                         */
+/*----------------------------------------------------------------------------*/
+/* pool - The pool to parse chunks on.                                        */
+/*                                                                            */
+/* chunks - The chunks to split the input into.  This is the most input which */
+/*          is parsed at once, so it should have at least a few chunks for    */
+/*          every worker of 'pool' to keep them all busy.                     */
+/*                                                                            */
+/* chunks_count - The number of elements in 'chunks'.  This must be at least  */
+/*                1.                                                          */
+/*----------------------------------------------------------------------------*/
+struct CliAuthImportWorkers {
+   struct CliAuthPool * pool;
+   struct CliAuthImportChunk * chunks;
+   CliAuthUInt32 chunks_count;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Parses newline-delimited key URIs from memory in parallel.  This works     */
+/* exactly like cliauth_import_text(), including calling 'function' for every */
+/* line in order from the calling thread, but splits the input into chunks at */
+/* line boundaries which are parsed across every worker of a pool.            */
+/*----------------------------------------------------------------------------*/
+/* workers - The resources to parse with.                                     */
+/*                                                                            */
+/* The remaining parameters and the return value are the same as              */
+/* cliauth_import_text().                                                     */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt64
+cliauth_import_text_parallel(
+   const struct CliAuthImportWorkers * workers,
+   const char text [],
+   CliAuthUInt64 text_characters,
+   CliAuthUInt64 line_first,
+   CliAuthImportFunction function,
+   void * context
+);
+
+/*----------------------------------------------------------------------------*/
+/* Parses a file of newline-delimited key URIs in parallel.  This works       */
+/* exactly like cliauth_import_file(), except memory-mapped files are parsed  */
+/* with cliauth_import_text_parallel().  Files which can't be mapped are      */
+/* still parsed on the calling thread alone.                                  */
+/*----------------------------------------------------------------------------*/
+/* workers - The resources to parse with.                                     */
+/*                                                                            */
+/* The remaining parameters and the return value are the same as              */
+/* cliauth_import_file().                                                     */
+/*----------------------------------------------------------------------------*/
+enum CliAuthImportResult
+cliauth_import_file_parallel(
+   const struct CliAuthImportWorkers * workers,
+   const char path [],
+   CliAuthImportFunction function,
+   void * context
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_IMPORT_H */
+
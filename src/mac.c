@@ -118,18 +118,20 @@ cliauth_mac_hmac_calculate_k0_opad_from_k0_ipad(
 }
 
 void
-cliauth_mac_hmac(
+cliauth_mac_hmac_key_initialize(
+   struct CliAuthMacHmacKey * hmac_key,
    const struct CliAuthHashFunction * hash_function,
    void * hash_context,
-   const void * message,
    const void * key,
    void * key_buffer,
-   void * digest,
-   CliAuthUInt32 message_bytes,
    CliAuthUInt32 key_bytes,
    CliAuthUInt32 block_bytes,
    CliAuthUInt32 digest_bytes
 ) {
+   hmac_key->hash_function = hash_function;
+   hmac_key->block_bytes = block_bytes;
+   hmac_key->digest_bytes = digest_bytes;
+
    /* calculate K0 ^ ipad */
    if (key_bytes == block_bytes) {
       cliauth_mac_hmac_calculate_k0_ipad_length_equal(
@@ -158,25 +160,369 @@ cliauth_mac_hmac(
       );
    }
 
-   /* calculate H((K0 ^ ipad) || message), store in 'digest' */ 
+   /* save the state after digesting K0 ^ ipad */
    hash_function->initialize(hash_context);
    hash_function->digest(hash_context, key_buffer, block_bytes);
-   hash_function->digest(hash_context, message, message_bytes);
-   hash_function->finalize(hash_context, digest);
+   hash_function->export_state(hash_context, &hmac_key->state_inner);
 
-   /* calculate K0 ^ opad from K0 ^ ipad*/
+   /* calculate K0 ^ opad from K0 ^ ipad */
    cliauth_mac_hmac_calculate_k0_opad_from_k0_ipad(
       key_buffer,
       block_bytes
    );
 
-   /* calculate H((K0 ^ opad) || H((K0 ^ ipad) || text)) */
-   /* store the final HMAC result in 'digest' */
+   /* save the state after digesting K0 ^ opad */
    hash_function->initialize(hash_context);
    hash_function->digest(hash_context, key_buffer, block_bytes);
-   hash_function->digest(hash_context, digest, digest_bytes);
+   hash_function->export_state(hash_context, &hmac_key->state_outer);
+
+   return;
+}
+
+void
+cliauth_mac_hmac_prepared(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * hash_context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+) {
+   const struct CliAuthHashFunction * hash_function;
+
+   hash_function = hmac_key->hash_function;
+
+   /* calculate H((K0 ^ ipad) || message), store in 'digest'.  for short */
+   /* messages such as OTP counters, this digests a single padded block */
+   hash_function->import_state(hash_context, &hmac_key->state_inner);
+   hash_function->digest_finalize(
+      hash_context,
+      message,
+      digest,
+      message_bytes
+   );
+
+   /* calculate H((K0 ^ opad) || H((K0 ^ ipad) || text)) */
+   /* store the final HMAC result in 'digest' */
+   hash_function->import_state(hash_context, &hmac_key->state_outer);
+   hash_function->digest_finalize(
+      hash_context,
+      digest,
+      digest,
+      hmac_key->digest_bytes
+   );
+
+   return;
+}
+
+/* an HMAC over a single key, run as a lane manager job.  the hash job comes */
+/* first, so completed hash jobs can be converted back. */
+struct CliAuthMacHmacBatchJob {
+   struct CliAuthHashJob hash_job;
+   const struct CliAuthMacHmacKey * hmac_key;
+   CliAuthBoolean outer;
+};
+
+/* takes completed jobs from a lane manager until there are none left.  jobs */
+/* which finished their inner hash are resubmitted for their outer hash, and */
+/* jobs which finished their outer hash are returned to 'jobs_free'.  when */
+/* 'flush' is true, partially filled lanes are run until every job is done. */
+static void
+cliauth_mac_hmac_batch_collect(
+   struct CliAuthHashLanes * lanes,
+   struct CliAuthMacHmacBatchJob * jobs_free [],
+   CliAuthUInt32 * jobs_free_count,
+   CliAuthBoolean flush
+) {
+   struct CliAuthHashJob * hash_job;
+   struct CliAuthMacHmacBatchJob * job;
+
+   if (flush == CLIAUTH_BOOLEAN_TRUE) {
+      hash_job = cliauth_hash_lanes_flush(lanes);
+   } else {
+      hash_job = cliauth_hash_lanes_complete(lanes);
+   }
+
+   while (hash_job != CLIAUTH_NULLPTR) {
+      job = (struct CliAuthMacHmacBatchJob *)hash_job;
+
+      if (job->outer == CLIAUTH_BOOLEAN_FALSE) {
+         /* calculate H((K0 ^ opad) || H((K0 ^ ipad) || text)) */
+         /* store the final HMAC result in the job's digest */
+         job->hmac_key->hash_function->import_state(
+            hash_job->context,
+            &job->hmac_key->state_outer
+         );
+         hash_job->message = hash_job->digest;
+         hash_job->message_bytes = job->hmac_key->digest_bytes;
+         job->outer = CLIAUTH_BOOLEAN_TRUE;
+
+         cliauth_hash_lanes_submit(lanes, hash_job);
+      } else {
+         jobs_free[*jobs_free_count] = job;
+         (*jobs_free_count)++;
+      }
+
+      if (flush == CLIAUTH_BOOLEAN_TRUE) {
+         hash_job = cliauth_hash_lanes_flush(lanes);
+      } else {
+         hash_job = cliauth_hash_lanes_complete(lanes);
+      }
+   }
+
+   return;
+}
+
+static CliAuthBoolean
+cliauth_mac_hmac_batch_function_done(
+   const struct CliAuthHashFunction * const functions_done [],
+   CliAuthUInt32 functions_done_count,
+   const struct CliAuthHashFunction * hash_function
+) {
+   while (functions_done_count != 0) {
+      if (*functions_done == hash_function) {
+         return CLIAUTH_BOOLEAN_TRUE;
+      }
+
+      functions_done++;
+      functions_done_count--;
+   }
+
+   return CLIAUTH_BOOLEAN_FALSE;
+}
+
+/* when 'messages' is CLIAUTH_NULLPTR, every key uses 'message' instead */
+static void
+cliauth_mac_hmac_batch_generic(
+   const struct CliAuthMacHmacKey * const hmac_keys [],
+   void * const hash_contexts [],
+   const void * const messages [],
+   const void * message,
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   const struct CliAuthHashFunction * functions_done [CLIAUTH_HASH_ENABLED_COUNT];
+   struct CliAuthMacHmacBatchJob jobs [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthMacHmacBatchJob * jobs_free [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthHashLanes lanes;
+   struct CliAuthMacHmacBatchJob * job;
+   const struct CliAuthHashFunction * hash_function;
+   CliAuthUInt32 functions_done_count, jobs_free_count;
+   CliAuthUInt32 first, next, i;
+
+   /* every job keeps the same hash context, so there is always one free */
+   /* for each job which isn't held by the lane manager */
+   i = 0;
+   while (i != CLIAUTH_HASH_LANES_MAX) {
+      jobs[i].hash_job.context = hash_contexts[i];
+      jobs_free[i] = &jobs[i];
+      i++;
+   }
+   jobs_free_count = CLIAUTH_HASH_LANES_MAX;
+
+   /* each pass runs every key using the hash function of the first key */
+   /* which hasn't been run yet, and finds the first key of the next pass */
+   functions_done_count = 0;
+   first = 0;
+   while (first != count) {
+      hash_function = hmac_keys[first]->hash_function;
+      next = count;
+
+      cliauth_hash_lanes_initialize(
+         &lanes,
+         hash_function,
+         hmac_keys[first]->block_bytes
+      );
+
+      i = first;
+      while (i != count) {
+         if (hmac_keys[i]->hash_function == hash_function) {
+            /* calculate H((K0 ^ ipad) || message), store in the digest */
+            jobs_free_count--;
+            job = jobs_free[jobs_free_count];
+            job->hmac_key = hmac_keys[i];
+            job->outer = CLIAUTH_BOOLEAN_FALSE;
+            job->hash_job.message = messages != CLIAUTH_NULLPTR ? messages[i] : message;
+            job->hash_job.digest = digests[i];
+            job->hash_job.message_bytes = message_bytes;
+
+            hash_function->import_state(
+               job->hash_job.context,
+               &hmac_keys[i]->state_inner
+            );
+
+            cliauth_hash_lanes_submit(&lanes, &job->hash_job);
+            cliauth_mac_hmac_batch_collect(
+               &lanes,
+               jobs_free,
+               &jobs_free_count,
+               CLIAUTH_BOOLEAN_FALSE
+            );
+         } else if (next == count && cliauth_mac_hmac_batch_function_done(
+            functions_done,
+            functions_done_count,
+            hmac_keys[i]->hash_function
+         ) == CLIAUTH_BOOLEAN_FALSE) {
+            next = i;
+         }
+
+         i++;
+      }
+
+      cliauth_mac_hmac_batch_collect(
+         &lanes,
+         jobs_free,
+         &jobs_free_count,
+         CLIAUTH_BOOLEAN_TRUE
+      );
+
+      functions_done[functions_done_count] = hash_function;
+      functions_done_count++;
+      first = next;
+   }
+
+   return;
+}
+
+void
+cliauth_mac_hmac_batch(
+   const struct CliAuthMacHmacKey * const hmac_keys [],
+   void * const hash_contexts [],
+   const void * message,
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_mac_hmac_batch_generic(
+      hmac_keys,
+      hash_contexts,
+      CLIAUTH_NULLPTR,
+      message,
+      digests,
+      message_bytes,
+      count
+   );
+
+   return;
+}
+
+void
+cliauth_mac_hmac_multi(
+   const struct CliAuthMacHmacKey * const hmac_keys [],
+   void * const hash_contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+) {
+   cliauth_mac_hmac_batch_generic(
+      hmac_keys,
+      hash_contexts,
+      messages,
+      CLIAUTH_NULLPTR,
+      digests,
+      message_bytes,
+      count
+   );
+
+   return;
+}
+
+void
+cliauth_mac_hmac_initialize(
+   struct CliAuthMacHmacContext * context,
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * hash_context
+) {
+   context->hmac_key = hmac_key;
+   context->hash_context = hash_context;
+
+   /* resume from H(K0 ^ ipad) to begin H((K0 ^ ipad) || message) */
+   hmac_key->hash_function->import_state(
+      hash_context,
+      &hmac_key->state_inner
+   );
+
+   return;
+}
+
+void
+cliauth_mac_hmac_digest(
+   struct CliAuthMacHmacContext * context,
+   const void * message,
+   CliAuthUInt32 message_bytes
+) {
+   context->hmac_key->hash_function->digest(
+      context->hash_context,
+      message,
+      message_bytes
+   );
+
+   return;
+}
+
+void
+cliauth_mac_hmac_finalize(
+   struct CliAuthMacHmacContext * context,
+   void * digest
+) {
+   const struct CliAuthMacHmacKey * hmac_key;
+   const struct CliAuthHashFunction * hash_function;
+   void * hash_context;
+
+   hmac_key = context->hmac_key;
+   hash_function = hmac_key->hash_function;
+   hash_context = context->hash_context;
+
+   /* calculate H((K0 ^ ipad) || message), store in 'digest' */
    hash_function->finalize(hash_context, digest);
-   
+
+   /* calculate H((K0 ^ opad) || H((K0 ^ ipad) || text)) */
+   /* store the final HMAC result in 'digest' */
+   hash_function->import_state(hash_context, &hmac_key->state_outer);
+   hash_function->digest_finalize(
+      hash_context,
+      digest,
+      digest,
+      hmac_key->digest_bytes
+   );
+
    return;
 }
 
+void
+cliauth_mac_hmac(
+   const struct CliAuthHashFunction * hash_function,
+   void * hash_context,
+   const void * message,
+   const void * key,
+   void * key_buffer,
+   void * digest,
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 key_bytes,
+   CliAuthUInt32 block_bytes,
+   CliAuthUInt32 digest_bytes
+) {
+   struct CliAuthMacHmacKey hmac_key;
+
+   cliauth_mac_hmac_key_initialize(
+      &hmac_key,
+      hash_function,
+      hash_context,
+      key,
+      key_buffer,
+      key_bytes,
+      block_bytes,
+      digest_bytes
+   );
+
+   cliauth_mac_hmac_prepared(
+      &hmac_key,
+      hash_context,
+      message,
+      digest,
+      message_bytes
+   );
+
+   return;
+}
@@ -50,14 +50,230 @@ cliauth_mac_hmac(
    void * hash_context,
    const void * message,
    const void * key,
-   void * digest,
    void * key_buffer,
+   void * digest,
    CliAuthUInt32 message_bytes,
    CliAuthUInt32 key_bytes,
    CliAuthUInt32 block_bytes,
    CliAuthUInt32 digest_bytes
 );
 
+/*----------------------------------------------------------------------------*/
+/* An HMAC key which has been prepared ahead of time.  This stores the hash   */
+/* states after digesting the inner and outer padded key blocks, so each HMAC */
+/* computed with it skips both pad blocks and any hashing of a long key.      */
+/* The fields should be considered private.                                   */
+/*----------------------------------------------------------------------------*/
+struct CliAuthMacHmacKey {
+   /* the hash function the key was prepared for */
+   const struct CliAuthHashFunction * hash_function;
+
+   /* hash state after digesting K0 ^ ipad */
+   union CliAuthHashState state_inner;
+
+   /* hash state after digesting K0 ^ opad */
+   union CliAuthHashState state_outer;
+
+   /* the byte length of the hash input blocks */
+   CliAuthUInt32 block_bytes;
+
+   /* the byte length of the hash digest */
+   CliAuthUInt32 digest_bytes;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Prepares an HMAC key for use with cliauth_mac_hmac_prepared().             */
+/*----------------------------------------------------------------------------*/
+/* hmac_key - The prepared key to initialize.                                 */
+/*                                                                            */
+/* hash_function - The hash function to use.                                  */
+/*                                                                            */
+/* hash_context - A pointer to a hash context struct which is valid for the   */
+/*                given hash function.                                        */
+/*                                                                            */
+/* key - Generic byte data to use as the key input.                           */
+/*                                                                            */
+/* key_buffer - A temporary byte buffer used internally.  Should be long      */
+/*              enough to store a single block as defined by the hash         */
+/*              algorithm.                                                    */
+/*                                                                            */
+/* key_bytes - The number of bytes to read from 'key'.                        */
+/*                                                                            */
+/* block_bytes - The byte length of the hash input blocks.  The block length  */
+/*               must be greater than or equal to the digest length.          */
+/*                                                                            */
+/* digest_bytes - The byte length of the hash digest.                         */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_key_initialize(
+   struct CliAuthMacHmacKey * hmac_key,
+   const struct CliAuthHashFunction * hash_function,
+   void * hash_context,
+   const void * key,
+   void * key_buffer,
+   CliAuthUInt32 key_bytes,
+   CliAuthUInt32 block_bytes,
+   CliAuthUInt32 digest_bytes
+);
+
+/*----------------------------------------------------------------------------*/
+/* Runs the HMAC algorithm using a prepared key.  The result is identical to  */
+/* cliauth_mac_hmac() with the key the prepared key was created from.         */
+/*----------------------------------------------------------------------------*/
+/* hmac_key - A key prepared with cliauth_mac_hmac_key_initialize().          */
+/*                                                                            */
+/* hash_context - A pointer to a hash context struct which is valid for the   */
+/*                key's hash function.                                        */
+/*                                                                            */
+/* message - Generic byte data to use as the message input.                   */
+/*                                                                            */
+/* digest - A byte array long enough to store the digest output as defined by */
+/*          the key's hash function.                                          */
+/*                                                                            */
+/* message_bytes - The number of bytes to read from 'message'.                */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_prepared(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * hash_context,
+   const void * message,
+   void * digest,
+   CliAuthUInt32 message_bytes
+);
+
+/*----------------------------------------------------------------------------*/
+/* Runs the HMAC algorithm over the same message with many prepared keys.     */
+/* Keys are grouped by hash function and run together through a hash lane     */
+/* manager, and the final inner block, which is identical for every key       */
+/* sharing a hash function, is only built once.                               */
+/* The results are identical to cliauth_mac_hmac_prepared() with each key.    */
+/*----------------------------------------------------------------------------*/
+/* hmac_keys - An array of 'count' pointers to keys prepared with             */
+/*             cliauth_mac_hmac_key_initialize().  The keys may use any mix   */
+/*             of hash functions.                                             */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every key's    */
+/*                 hash function.                                             */
+/*                                                                            */
+/* message - Generic byte data to use as the message input for every key.     */
+/*                                                                            */
+/* digests - An array of 'count' byte arrays, each long enough to store the   */
+/*           digest output of the key at the same index.                      */
+/*                                                                            */
+/* message_bytes - The number of bytes to read from 'message'.                */
+/*                                                                            */
+/* count - The number of entries in 'hmac_keys' and 'digests'.                */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_batch(
+   const struct CliAuthMacHmacKey * const hmac_keys [],
+   void * const hash_contexts [],
+   const void * message,
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+);
+
+/*----------------------------------------------------------------------------*/
+/* Runs the HMAC algorithm with many prepared keys, each over its own         */
+/* message.  Every message must have the same length.  This works the same as */
+/* cliauth_mac_hmac_batch(), except that only keys which share both a hash    */
+/* function and message contents share their final inner block.               */
+/*----------------------------------------------------------------------------*/
+/* hmac_keys - An array of 'count' pointers to keys prepared with             */
+/*             cliauth_mac_hmac_key_initialize().  The keys may use any mix   */
+/*             of hash functions.                                             */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every key's    */
+/*                 hash function.                                             */
+/*                                                                            */
+/* messages - An array of 'count' pointers to the message input for the key   */
+/*            at the same index.                                              */
+/*                                                                            */
+/* digests - An array of 'count' byte arrays, each long enough to store the   */
+/*           digest output of the key at the same index.                      */
+/*                                                                            */
+/* message_bytes - The number of bytes to read from each message.             */
+/*                                                                            */
+/* count - The number of entries in 'hmac_keys', 'messages' and 'digests'.    */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_multi(
+   const struct CliAuthMacHmacKey * const hmac_keys [],
+   void * const hash_contexts [],
+   const void * const messages [],
+   void * const digests [],
+   CliAuthUInt32 message_bytes,
+   CliAuthUInt32 count
+);
+
+/*----------------------------------------------------------------------------*/
+/* A streaming HMAC computation over a prepared key.  This allows a message   */
+/* to be authenticated in pieces without first being copied into a single     */
+/* contiguous buffer.  The fields should be considered private.               */
+/*----------------------------------------------------------------------------*/
+struct CliAuthMacHmacContext {
+   /* the prepared key being used */
+   const struct CliAuthMacHmacKey * hmac_key;
+
+   /* the caller-provided hash context the message is streamed into */
+   void * hash_context;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Starts a streaming HMAC computation.                                       */
+/*----------------------------------------------------------------------------*/
+/* context - The HMAC context to initialize.                                  */
+/*                                                                            */
+/* hmac_key - A key prepared with cliauth_mac_hmac_key_initialize().  This    */
+/*            must remain valid until the computation is finalized.           */
+/*                                                                            */
+/* hash_context - A pointer to a hash context struct which is valid for the   */
+/*                key's hash function.  This is used to store the state of    */
+/*                the computation, and must remain valid and otherwise        */
+/*                unused until the computation is finalized.                  */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_initialize(
+   struct CliAuthMacHmacContext * context,
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * hash_context
+);
+
+/*----------------------------------------------------------------------------*/
+/* Appends message data to a streaming HMAC computation.  This may be called  */
+/* any number of times with pieces of any length.                             */
+/*----------------------------------------------------------------------------*/
+/* context - The HMAC context to use.                                         */
+/*                                                                            */
+/* message - Generic byte data to append to the message.                      */
+/*                                                                            */
+/* message_bytes - The number of bytes to read from 'message'.                */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_digest(
+   struct CliAuthMacHmacContext * context,
+   const void * message,
+   CliAuthUInt32 message_bytes
+);
+
+/*----------------------------------------------------------------------------*/
+/* Completes a streaming HMAC computation.  The context must be initialized   */
+/* again before it can be reused.                                             */
+/*----------------------------------------------------------------------------*/
+/* context - The HMAC context to use.                                         */
+/*                                                                            */
+/* digest - A byte array long enough to store the digest output as defined by */
+/*          the key's hash function.                                          */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_mac_hmac_finalize(
+   struct CliAuthMacHmacContext * context,
+   void * digest
+);
+
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_MAC_H */
 
@@ -13,6 +13,59 @@
 #include "hash.h"
 #include "mac.h"
 
+/* the maximum number of digits allowed in a one-time-password */
+#define _CLIAUTH_OTP_DIGITS_MAX 9
+
+/* the number of table accounts processed together on the stack */
+#define _CLIAUTH_OTP_TABLE_CHUNK 64
+
+/* the values of 10^digits, indexed by the number of digits */
+static const CliAuthUInt32
+cliauth_otp_powers_of_ten [_CLIAUTH_OTP_DIGITS_MAX + 1] = {
+   1,
+   10,
+   100,
+   1000,
+   10000,
+   100000,
+   1000000,
+   10000000,
+   100000000,
+   1000000000
+};
+
+/* reciprocals which compute (passcode / 10^digits) as */
+/* (passcode * multiplier) >> shift, exact for every 31-bit passcode.  each */
+/* multiplier is ceil(2^shift / 10^digits), where shift is */
+/* 31 + ceil(log2(10^digits)) */
+static const CliAuthUInt32
+cliauth_otp_reciprocal_multipliers [_CLIAUTH_OTP_DIGITS_MAX + 1] = {
+   0x80000000,
+   0xcccccccd,
+   0xa3d70a3e,
+   0x83126e98,
+   0xd1b71759,
+   0xa7c5ac48,
+   0x8637bd06,
+   0xd6bf94d6,
+   0xabcc7712,
+   0x89705f42
+};
+
+static const CliAuthUInt8
+cliauth_otp_reciprocal_shifts [_CLIAUTH_OTP_DIGITS_MAX + 1] = {
+   31,
+   35,
+   38,
+   41,
+   45,
+   48,
+   51,
+   55,
+   58,
+   61
+};
+
 static CliAuthUInt32
 cliauth_otp_hotp_truncate_digest(
    const void * digest,
@@ -42,15 +95,124 @@ cliauth_otp_hotp_trim_digits(
    CliAuthUInt32 passcode,
    CliAuthUInt8 digits
 ) {
-   CliAuthUInt32 modulus;
+   CliAuthUInt32 quotient;
+
+   /* passcode % 10^digits, with the division done by reciprocal multiply */
+   quotient = (CliAuthUInt32)(
+      ((CliAuthUInt64)passcode * cliauth_otp_reciprocal_multipliers[digits]) >>
+      cliauth_otp_reciprocal_shifts[digits]
+   );
+
+   return passcode - (quotient * cliauth_otp_powers_of_ten[digits]);
+}
+
+/* the same as cliauth_otp_hotp_truncate_digest() for every digest, without */
+/* any branches or calls so the loop can be vectorised */
+static void
+cliauth_otp_hotp_truncate_digests(
+   const union CliAuthOtpBuffersGenericDigest digests [],
+   const struct CliAuthMacHmacKey * const hmac_keys [],
+   CliAuthUInt32 passcodes [],
+   CliAuthUInt32 count
+) {
+   const CliAuthUInt8 * digest_bytes;
+   CliAuthUInt32 offset;
+   CliAuthUInt32 i;
+
+   i = 0;
+   while (i != count) {
+      digest_bytes = (const CliAuthUInt8 *)&digests[i];
+      offset = digest_bytes[hmac_keys[i]->digest_bytes - 1] & 0x0f;
+
+      passcodes[i] =
+         ((CliAuthUInt32)(digest_bytes[offset + 0] & 0x7f) << 24) |
+         ((CliAuthUInt32)(digest_bytes[offset + 1]       ) << 16) |
+         ((CliAuthUInt32)(digest_bytes[offset + 2]       ) <<  8) |
+         ((CliAuthUInt32)(digest_bytes[offset + 3]       ) <<  0);
+
+      i++;
+   }
+
+   return;
+}
+
+/* the same as cliauth_otp_hotp_trim_digits() for every passcode, without */
+/* any branches or calls so the loop can be vectorised */
+static void
+cliauth_otp_hotp_trim_digits_multi(
+   CliAuthUInt32 passcodes [],
+   const CliAuthUInt8 digits [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 quotient;
+   CliAuthUInt32 i;
+
+   i = 0;
+   while (i != count) {
+      quotient = (CliAuthUInt32)(
+         ((CliAuthUInt64)passcodes[i] * cliauth_otp_reciprocal_multipliers[digits[i]]) >>
+         cliauth_otp_reciprocal_shifts[digits[i]]
+      );
+
+      passcodes[i] -= quotient * cliauth_otp_powers_of_ten[digits[i]];
+
+      i++;
+   }
+
+   return;
+}
+
+void
+cliauth_otp_hotp_multi(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt32 passcodes [],
+   const CliAuthUInt64 counters [],
+   CliAuthUInt32 count,
+   CliAuthUInt8 digits
+) {
+   union CliAuthOtpBuffersGenericDigest digests [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 counters_big_endian [CLIAUTH_HASH_LANES_MAX];
+   const struct CliAuthMacHmacKey * hmac_keys [CLIAUTH_HASH_LANES_MAX];
+   const void * messages [CLIAUTH_HASH_LANES_MAX];
+   void * digest_pointers [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt32 i;
+
+   /* the pointers are set for every lane rather than only 'count' lanes, */
+   /* which lets the compiler see the arrays are always initialized */
+   i = 0;
+   while (i != CLIAUTH_HASH_LANES_MAX) {
+      hmac_keys[i] = hmac_key;
+      messages[i] = &counters_big_endian[i];
+      digest_pointers[i] = &digests[i];
+      i++;
+   }
+
+   i = 0;
+   while (i != count) {
+      counters_big_endian[i] = cliauth_endian_host_to_big_uint64(counters[i]);
+      i++;
+   }
+
+   cliauth_mac_hmac_multi(
+      hmac_keys,
+      hash_contexts,
+      messages,
+      digest_pointers,
+      sizeof(counters_big_endian[0]),
+      count
+   );
 
-   modulus = 1;
-   while (digits != 0) {
-      modulus *= 10;
-      digits--;
+   i = 0;
+   while (i != count) {
+      passcodes[i] = cliauth_otp_hotp_trim_digits(
+         cliauth_otp_hotp_truncate_digest(&digests[i], hmac_key->digest_bytes),
+         digits
+      );
+      i++;
    }
 
-   return passcode % modulus;
+   return;
 }
 
 CliAuthUInt32
@@ -138,3 +300,350 @@ cliauth_otp_totp(
    return passcode;
 }
 
+CliAuthBoolean
+cliauth_otp_hotp_verify(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt64 * counter_matched,
+   CliAuthUInt64 counter,
+   CliAuthUInt32 passcode,
+   CliAuthUInt32 window,
+   CliAuthUInt8 digits
+) {
+   CliAuthUInt64 counters [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt32 passcodes [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 offset, total;
+   CliAuthUInt32 lanes, lane;
+
+   /* 64-bit so a window of the maximum size doesn't overflow */
+   total = (CliAuthUInt64)window + 1;
+
+   offset = 0;
+   while (offset != total) {
+      lanes = CLIAUTH_HASH_LANES_MAX;
+      if (total - offset < lanes) {
+         lanes = (CliAuthUInt32)(total - offset);
+      }
+
+      lane = 0;
+      while (lane != lanes) {
+         counters[lane] = counter + offset + lane;
+         lane++;
+      }
+
+      cliauth_otp_hotp_multi(
+         hmac_key,
+         hash_contexts,
+         passcodes,
+         counters,
+         lanes,
+         digits
+      );
+
+      lane = 0;
+      while (lane != lanes) {
+         if (passcodes[lane] == passcode) {
+            *counter_matched = counter + offset + lane;
+            return CLIAUTH_BOOLEAN_TRUE;
+         }
+
+         lane++;
+      }
+
+      offset += lanes;
+   }
+
+   return CLIAUTH_BOOLEAN_FALSE;
+}
+
+CliAuthBoolean
+cliauth_otp_hotp_resync(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt64 * counter_matched,
+   CliAuthUInt64 counter,
+   CliAuthUInt32 passcode_first,
+   CliAuthUInt32 passcode_second,
+   CliAuthUInt32 window,
+   CliAuthUInt8 digits
+) {
+   CliAuthUInt64 counters [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt32 passcodes [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 offset, total;
+   CliAuthUInt32 lanes, lane;
+   CliAuthBoolean previous_matched;
+
+   /* every counter in the window may match 'passcode_first', plus one more */
+   /* counter for 'passcode_second' after the last one */
+   total = (CliAuthUInt64)window + 2;
+
+   previous_matched = CLIAUTH_BOOLEAN_FALSE;
+   offset = 0;
+   while (offset != total) {
+      lanes = CLIAUTH_HASH_LANES_MAX;
+      if (total - offset < lanes) {
+         lanes = (CliAuthUInt32)(total - offset);
+      }
+
+      lane = 0;
+      while (lane != lanes) {
+         counters[lane] = counter + offset + lane;
+         lane++;
+      }
+
+      cliauth_otp_hotp_multi(
+         hmac_key,
+         hash_contexts,
+         passcodes,
+         counters,
+         lanes,
+         digits
+      );
+
+      /* the match state carries across chunks, so pairs which straddle */
+      /* two chunks are still found */
+      lane = 0;
+      while (lane != lanes) {
+         if (
+            previous_matched == CLIAUTH_BOOLEAN_TRUE &&
+            passcodes[lane] == passcode_second
+         ) {
+            *counter_matched = counter + offset + lane;
+            return CLIAUTH_BOOLEAN_TRUE;
+         }
+
+         if (passcodes[lane] == passcode_first) {
+            previous_matched = CLIAUTH_BOOLEAN_TRUE;
+         } else {
+            previous_matched = CLIAUTH_BOOLEAN_FALSE;
+         }
+
+         lane++;
+      }
+
+      offset += lanes;
+   }
+
+   return CLIAUTH_BOOLEAN_FALSE;
+}
+
+CliAuthBoolean
+cliauth_otp_totp_verify(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthSInt64 * step_matched,
+   CliAuthUInt64 time_initial,
+   CliAuthUInt64 time_current,
+   CliAuthUInt64 time_interval,
+   CliAuthUInt32 passcode,
+   CliAuthUInt32 window,
+   CliAuthUInt8 digits
+) {
+   CliAuthUInt64 counters [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt32 passcodes [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 counter, counter_matched, distance;
+   CliAuthUInt64 index, total;
+   CliAuthUInt64 match, found, select;
+   CliAuthUInt32 lanes, lane;
+
+   counter = (time_current - time_initial) / time_interval;
+
+   /* 64-bit so a window of the maximum size doesn't overflow */
+   total = ((CliAuthUInt64)window * 2) + 1;
+
+   found = 0;
+   counter_matched = 0;
+   index = 0;
+   while (index != total) {
+      /* candidates are visited in order of distance from the current step, */
+      /* as 0, -1, +1, -2, +2, ...  steps before the initial time are */
+      /* skipped */
+      lanes = 0;
+      while (lanes != CLIAUTH_HASH_LANES_MAX && index != total) {
+         distance = (index + 1) / 2;
+
+         if (index % 2 == 0) {
+            counters[lanes] = counter + distance;
+            lanes++;
+         } else if (distance <= counter) {
+            counters[lanes] = counter - distance;
+            lanes++;
+         }
+
+         index++;
+      }
+
+      cliauth_otp_hotp_multi(
+         hmac_key,
+         hash_contexts,
+         passcodes,
+         counters,
+         lanes,
+         digits
+      );
+
+      /* compare every candidate without branching, keeping the first match */
+      /* found, which is the one closest to the current step */
+      lane = 0;
+      while (lane != lanes) {
+         match = (CliAuthUInt64)0 - (CliAuthUInt64)(passcodes[lane] == passcode);
+         select = match & ~found;
+         counter_matched = (counter_matched & ~select) | (counters[lane] & select);
+         found |= match;
+         lane++;
+      }
+   }
+
+   if (found == 0) {
+      return CLIAUTH_BOOLEAN_FALSE;
+   }
+
+   if (counter_matched >= counter) {
+      *step_matched = (CliAuthSInt64)(counter_matched - counter);
+   } else {
+      *step_matched = -(CliAuthSInt64)(counter - counter_matched);
+   }
+
+   return CLIAUTH_BOOLEAN_TRUE;
+}
+
+/* runs up to _CLIAUTH_OTP_TABLE_CHUNK accounts of a table.  when 'accounts' */
+/* is CLIAUTH_NULLPTR, the accounts starting at index 'first' are run, */
+/* otherwise the accounts listed in 'accounts' are */
+static void
+cliauth_otp_totp_table_chunk(
+   const struct CliAuthOtpTotpTable * table,
+   void * const hash_contexts [],
+   const CliAuthUInt32 accounts [],
+   CliAuthUInt32 passcodes [],
+   CliAuthUInt64 time_current,
+   CliAuthUInt32 first,
+   CliAuthUInt32 count
+) {
+   union CliAuthOtpBuffersGenericDigest digests [_CLIAUTH_OTP_TABLE_CHUNK];
+   CliAuthUInt64 counters [_CLIAUTH_OTP_TABLE_CHUNK];
+   const struct CliAuthMacHmacKey * hmac_keys [_CLIAUTH_OTP_TABLE_CHUNK];
+   const void * messages [_CLIAUTH_OTP_TABLE_CHUNK];
+   void * digest_pointers [_CLIAUTH_OTP_TABLE_CHUNK];
+   CliAuthUInt8 digits [_CLIAUTH_OTP_TABLE_CHUNK];
+   CliAuthUInt32 account, i;
+
+   /* calculate the big-endian counters.  accounts whose counter matches */
+   /* the first account of the chunk share its message, which lets the */
+   /* HMAC share their final inner blocks */
+   i = 0;
+   while (i != count) {
+      if (accounts != CLIAUTH_NULLPTR) {
+         account = accounts[i];
+      } else {
+         account = first + i;
+      }
+
+      counters[i] = cliauth_endian_host_to_big_uint64(
+         (time_current - table->time_initial[account]) /
+         table->time_interval[account]
+      );
+
+      if (counters[i] == counters[0]) {
+         messages[i] = &counters[0];
+      } else {
+         messages[i] = &counters[i];
+      }
+
+      hmac_keys[i] = &table->hmac_keys[account];
+      digest_pointers[i] = &digests[i];
+      digits[i] = table->digits[account];
+      i++;
+   }
+
+   cliauth_mac_hmac_multi(
+      hmac_keys,
+      hash_contexts,
+      messages,
+      digest_pointers,
+      sizeof(counters[0]),
+      count
+   );
+
+   cliauth_otp_hotp_truncate_digests(
+      digests,
+      hmac_keys,
+      passcodes,
+      count
+   );
+
+   cliauth_otp_hotp_trim_digits_multi(
+      passcodes,
+      digits,
+      count
+   );
+
+   return;
+}
+
+void
+cliauth_otp_totp_table(
+   const struct CliAuthOtpTotpTable * table,
+   void * const hash_contexts [],
+   CliAuthUInt32 passcodes [],
+   CliAuthUInt64 time_current
+) {
+   CliAuthUInt32 first, chunk;
+
+   first = 0;
+   while (first != table->count) {
+      chunk = table->count - first;
+      if (chunk > _CLIAUTH_OTP_TABLE_CHUNK) {
+         chunk = _CLIAUTH_OTP_TABLE_CHUNK;
+      }
+
+      cliauth_otp_totp_table_chunk(
+         table,
+         hash_contexts,
+         CLIAUTH_NULLPTR,
+         &passcodes[first],
+         time_current,
+         first,
+         chunk
+      );
+
+      first += chunk;
+   }
+
+   return;
+}
+
+void
+cliauth_otp_totp_table_select(
+   const struct CliAuthOtpTotpTable * table,
+   void * const hash_contexts [],
+   const CliAuthUInt32 accounts [],
+   CliAuthUInt32 passcodes [],
+   CliAuthUInt64 time_current,
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 first, chunk;
+
+   first = 0;
+   while (first != count) {
+      chunk = count - first;
+      if (chunk > _CLIAUTH_OTP_TABLE_CHUNK) {
+         chunk = _CLIAUTH_OTP_TABLE_CHUNK;
+      }
+
+      cliauth_otp_totp_table_chunk(
+         table,
+         hash_contexts,
+         &accounts[first],
+         &passcodes[first],
+         time_current,
+         0,
+         chunk
+      );
+
+      first += chunk;
+   }
+
+   return;
+}
+
@@ -11,6 +11,92 @@
 
 #include "cliauth.h"
 #include "hash.h"
+#include "mac.h"
+
+union CliAuthOtpBuffersGenericHashContext {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   struct CliAuthHashContextSha1 sha1;
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if CLIAUTH_CONFIG_HASH_SHA224
+   struct CliAuthHashContextSha232 sha224;
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
+#if CLIAUTH_CONFIG_HASH_SHA256
+   struct CliAuthHashContextSha232 sha256;
+#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
+#if CLIAUTH_CONFIG_HASH_SHA384
+   struct CliAuthHashContextSha264 sha384;
+#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
+#if CLIAUTH_CONFIG_HASH_SHA512
+   struct CliAuthHashContextSha264 sha512;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
+#if CLIAUTH_CONFIG_HASH_SHA512_224
+   struct CliAuthHashContextSha264 sha512_224;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
+#if CLIAUTH_CONFIG_HASH_SHA512_256
+   struct CliAuthHashContextSha264 sha512_256;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
+};
+
+union CliAuthOtpBuffersGenericDigest {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   CliAuthUInt8 sha1 [CLIAUTH_HASH_SHA1_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if CLIAUTH_CONFIG_HASH_SHA224
+   CliAuthUInt8 sha224 [CLIAUTH_HASH_SHA224_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
+#if CLIAUTH_CONFIG_HASH_SHA256
+   CliAuthUInt8 sha256 [CLIAUTH_HASH_SHA256_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
+#if CLIAUTH_CONFIG_HASH_SHA384
+   CliAuthUInt8 sha384 [CLIAUTH_HASH_SHA384_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
+#if CLIAUTH_CONFIG_HASH_SHA512
+   CliAuthUInt8 sha512 [CLIAUTH_HASH_SHA512_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
+#if CLIAUTH_CONFIG_HASH_SHA512_224
+   CliAuthUInt8 sha512_224 [CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
+#if CLIAUTH_CONFIG_HASH_SHA512_256
+   CliAuthUInt8 sha512_256 [CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
+};
+
+union CliAuthOtpBuffersGenericKey {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   CliAuthUInt8 sha1 [CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if CLIAUTH_CONFIG_HASH_SHA224
+   CliAuthUInt8 sha224 [CLIAUTH_HASH_SHA224_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
+#if CLIAUTH_CONFIG_HASH_SHA256
+   CliAuthUInt8 sha256 [CLIAUTH_HASH_SHA256_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
+#if CLIAUTH_CONFIG_HASH_SHA384
+   CliAuthUInt8 sha384 [CLIAUTH_HASH_SHA384_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
+#if CLIAUTH_CONFIG_HASH_SHA512
+   CliAuthUInt8 sha512 [CLIAUTH_HASH_SHA512_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
+#if CLIAUTH_CONFIG_HASH_SHA512_224
+   CliAuthUInt8 sha512_224 [CLIAUTH_HASH_SHA512_224_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
+#if CLIAUTH_CONFIG_HASH_SHA512_256
+   CliAuthUInt8 sha512_256 [CLIAUTH_HASH_SHA512_256_INPUT_BLOCK_LENGTH];
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
+};
+
+/*----------------------------------------------------------------------------*/
+/* Generic buffers large enough to run the OTP algorithms with every enabled  */
+/* hash algorithm.  This union trick allows the stack layout and memory usage */
+/* to be figured out at compile time with a runtime-chosen hash function      */
+/* without relying on either guessing properly sized buffers or using too     */
+/* much preprocessor slop.                                                    */
+/*----------------------------------------------------------------------------*/
+struct CliAuthOtpBuffersGeneric {
+   union CliAuthOtpBuffersGenericHashContext hash_context;
+   union CliAuthOtpBuffersGenericDigest digest_buffer;
+   union CliAuthOtpBuffersGenericKey key_buffer;
+};
 
 /*----------------------------------------------------------------------------*/
 /* Runs the HMAC-based One Time Password (HOTP) algorithm.                    */
@@ -120,6 +206,274 @@ cliauth_otp_totp(
    CliAuthUInt8 digits
 );
 
+/*----------------------------------------------------------------------------*/
+/* Runs the HMAC-based One Time Password (HOTP) algorithm with a prepared key */
+/* for several counters at once, using the lanes of the multi-lane hash       */
+/* functions.                                                                 */
+/*----------------------------------------------------------------------------*/
+/* hmac_key - The account key, prepared with                                  */
+/*            cliauth_mac_hmac_key_initialize().                              */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for the key's hash */
+/*                 function.                                                  */
+/*                                                                            */
+/* passcodes - An array of 'count' entries which the one-time-password of     */
+/*             the counter at the same index is written to.                   */
+/*                                                                            */
+/* counters - An array of 'count' counter values for the HOTP algorithm.      */
+/*                                                                            */
+/* count - The number of counters, which may not be greater than              */
+/*         CLIAUTH_HASH_LANES_MAX.                                            */
+/*                                                                            */
+/* digits - The number of digits, base 10, to include in the final HOTP       */
+/*          output.  This must be at least 1, and may not be greater than 9.  */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_otp_hotp_multi(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt32 passcodes [],
+   const CliAuthUInt64 counters [],
+   CliAuthUInt32 count,
+   CliAuthUInt8 digits
+);
+
+/*----------------------------------------------------------------------------*/
+/* Verifies a HMAC-based One Time Password (HOTP) against a window of         */
+/* counters starting at the stored counter, as described by RFC 4226 section  */
+/* 7.2.  The key pads are never re-derived, and the candidate counters are    */
+/* computed several at a time in the lanes of the multi-lane hash functions,  */
+/* stopping at the first match.                                               */
+/*----------------------------------------------------------------------------*/
+/* hmac_key - The account key, prepared with                                  */
+/*            cliauth_mac_hmac_key_initialize().                              */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for the key's hash */
+/*                 function.                                                  */
+/*                                                                            */
+/* counter_matched - Receives the counter which generated 'passcode' if it    */
+/*                   was found.  The stored counter should then be advanced   */
+/*                   to one past this value.  Left unmodified otherwise.      */
+/*                                                                            */
+/* counter - The stored counter, which is the first counter to check.         */
+/*                                                                            */
+/* passcode - The submitted one-time-password.                                */
+/*                                                                            */
+/* window - The number of counters past 'counter' to also check.  A window of */
+/*          zero only checks 'counter' itself.                                */
+/*                                                                            */
+/* digits - The number of digits, base 10, of the one-time-passwords.  This   */
+/*          must be at least 1, and may not be greater than 9.                */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if 'passcode' matched a counter in the */
+/*                window, otherwise CLIAUTH_BOOLEAN_FALSE.                    */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_otp_hotp_verify(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt64 * counter_matched,
+   CliAuthUInt64 counter,
+   CliAuthUInt32 passcode,
+   CliAuthUInt32 window,
+   CliAuthUInt8 digits
+);
+
+/*----------------------------------------------------------------------------*/
+/* Resynchronizes a HOTP counter which has drifted past the normal            */
+/* verification window, as described by RFC 4226 appendix E.4.  The user      */
+/* submits two consecutive one-time-passwords, which are searched for over a  */
+/* large window.  Requiring both to match keeps the chance of a false match   */
+/* low even with a large window.  The search works the same way as            */
+/* cliauth_otp_hotp_verify().                                                 */
+/*----------------------------------------------------------------------------*/
+/* hmac_key - The account key, prepared with                                  */
+/*            cliauth_mac_hmac_key_initialize().                              */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for the key's hash */
+/*                 function.                                                  */
+/*                                                                            */
+/* counter_matched - Receives the counter which generated 'passcode_second'   */
+/*                   if the pair was found.  The stored counter should then   */
+/*                   be advanced to one past this value.  Left unmodified     */
+/*                   otherwise.                                               */
+/*                                                                            */
+/* counter - The stored counter, which is the first counter to check for      */
+/*           'passcode_first'.                                                */
+/*                                                                            */
+/* passcode_first - The first of the two consecutive one-time-passwords.      */
+/*                                                                            */
+/* passcode_second - The one-time-password generated immediately after        */
+/*                   'passcode_first'.                                        */
+/*                                                                            */
+/* window - The number of counters past 'counter' to also check for           */
+/*          'passcode_first'.                                                 */
+/*                                                                            */
+/* digits - The number of digits, base 10, of the one-time-passwords.  This   */
+/*          must be at least 1, and may not be greater than 9.                */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if the pair of passcodes matched       */
+/*                consecutive counters in the window, otherwise               */
+/*                CLIAUTH_BOOLEAN_FALSE.                                      */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_otp_hotp_resync(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt64 * counter_matched,
+   CliAuthUInt64 counter,
+   CliAuthUInt32 passcode_first,
+   CliAuthUInt32 passcode_second,
+   CliAuthUInt32 window,
+   CliAuthUInt8 digits
+);
+
+/*----------------------------------------------------------------------------*/
+/* Verifies a Time-based One Time Password (TOTP) against the steps within a  */
+/* window around the current time step, allowing for clock skew between the   */
+/* client and server as described by RFC 6238 section 5.2.  Every candidate   */
+/* step is computed from the prepared key in the lanes of the multi-lane hash */
+/* functions and compared without branching.  If several steps match, the one */
+/* closest to the current step is reported, preferring the earlier step on a  */
+/* tie.                                                                       */
+/*----------------------------------------------------------------------------*/
+/* hmac_key - The account key, prepared with                                  */
+/*            cliauth_mac_hmac_key_initialize().                              */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for the key's hash */
+/*                 function.                                                  */
+/*                                                                            */
+/* step_matched - Receives the offset of the matched step from the current    */
+/*                step if 'passcode' was found, where negative values are in  */
+/*                the past.  Left unmodified otherwise.                       */
+/*                                                                            */
+/* time_initial - The timestamp to start counting from, in seconds relative   */
+/*                to the Unix epoch.                                          */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to 'time_initial'.                                    */
+/*                                                                            */
+/* time_interval - The interval at which to generate a new password, in       */
+/*                 seconds.  This must be greater than zero.                  */
+/*                                                                            */
+/* passcode - The submitted one-time-password.                                */
+/*                                                                            */
+/* window - The number of steps on either side of the current step to also    */
+/*          check.  Steps before 'time_initial' are never checked.            */
+/*                                                                            */
+/* digits - The number of digits, base 10, of the one-time-passwords.  This   */
+/*          must be at least 1, and may not be greater than 9.                */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if 'passcode' matched a step in the    */
+/*                window, otherwise CLIAUTH_BOOLEAN_FALSE.                    */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_otp_totp_verify(
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthSInt64 * step_matched,
+   CliAuthUInt64 time_initial,
+   CliAuthUInt64 time_current,
+   CliAuthUInt64 time_interval,
+   CliAuthUInt32 passcode,
+   CliAuthUInt32 window,
+   CliAuthUInt8 digits
+);
+
+/*----------------------------------------------------------------------------*/
+/* A table of TOTP accounts stored as parallel arrays, where the entries at   */
+/* the same index of each array describe one account.  Keeping each field in  */
+/* its own contiguous array lets cliauth_otp_totp_table() stream through the  */
+/* table instead of chasing per-account structs.  The arrays are owned by the */
+/* caller and are never modified.                                             */
+/*----------------------------------------------------------------------------*/
+/* hmac_keys - The account keys, prepared with                                */
+/*             cliauth_mac_hmac_key_initialize().  Accounts may use any mix   */
+/*             of hash functions.                                             */
+/*                                                                            */
+/* time_initial - The timestamp to start counting from for each account, in   */
+/*                seconds relative to the Unix epoch.                         */
+/*                                                                            */
+/* time_interval - The interval at which to generate a new password for each  */
+/*                 account, in seconds.  Each must be greater than zero.      */
+/*                                                                            */
+/* digits - The number of digits, base 10, of each account's passwords.  Each */
+/*          must be at least 1, and may not be greater than 9.                */
+/*                                                                            */
+/* count - The number of accounts, which is the length of every array.        */
+/*----------------------------------------------------------------------------*/
+struct CliAuthOtpTotpTable {
+   const struct CliAuthMacHmacKey * hmac_keys;
+   const CliAuthUInt64 * time_initial;
+   const CliAuthUInt64 * time_interval;
+   const CliAuthUInt8 * digits;
+   CliAuthUInt32 count;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Runs the Time-based One Time Password (TOTP) algorithm for every account   */
+/* in a table at once.  The HMACs are computed with cliauth_mac_hmac_multi(), */
+/* and the truncation and digit trimming are run as loops over whole arrays   */
+/* of accounts.  The results are identical to calling cliauth_otp_totp() for  */
+/* each account.                                                              */
+/*----------------------------------------------------------------------------*/
+/* table - The account table to generate passwords for.                       */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every          */
+/*                 account's hash function.                                   */
+/*                                                                            */
+/* passcodes - An array of 'table->count' entries which the one-time-password */
+/*             of each account is written to.                                 */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to every account's initial time.                      */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_otp_totp_table(
+   const struct CliAuthOtpTotpTable * table,
+   void * const hash_contexts [],
+   CliAuthUInt32 passcodes [],
+   CliAuthUInt64 time_current
+);
+
+/*----------------------------------------------------------------------------*/
+/* Runs the Time-based One Time Password (TOTP) algorithm for a subset of the */
+/* accounts in a table, the same way as cliauth_otp_totp_table().             */
+/*----------------------------------------------------------------------------*/
+/* table - The account table to generate passwords for.                       */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every          */
+/*                 selected account's hash function.                          */
+/*                                                                            */
+/* accounts - An array of 'count' indices of the accounts to run.             */
+/*                                                                            */
+/* passcodes - An array of 'count' entries which the one-time-password of     */
+/*             the account at the same index of 'accounts' is written to.     */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to every selected account's initial time.             */
+/*                                                                            */
+/* count - The number of entries in 'accounts' and 'passcodes'.               */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_otp_totp_table_select(
+   const struct CliAuthOtpTotpTable * table,
+   void * const hash_contexts [],
+   const CliAuthUInt32 accounts [],
+   CliAuthUInt32 passcodes [],
+   CliAuthUInt64 time_current,
+   CliAuthUInt32 count
+);
+
 /*----------------------------------------------------------------------------*/
 #endif /* _CLIAUTH_OTP_H */
 
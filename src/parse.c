@@ -9,7 +9,9 @@
 #include "parse.h"
 
 #include <string.h>
+#include "cpu.h"
 #include "hash.h"
+#include "parse_x86.h"
 
 static enum CliAuthParseIntegerResult
 cliauth_parse_integer_digit(
@@ -150,6 +152,27 @@ cliauth_parse_hash_identifier_list [CLIAUTH_HASH_ENABLED_COUNT] = {
 #endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
 };
 
+/* the position of each enabled hash in the lists above and below */
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA1 0
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA224 (\
+      _CLIAUTH_PARSE_HASH_INDEX_SHA1 + CLIAUTH_CONFIG_HASH_SHA1\
+   )
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA256 (\
+      _CLIAUTH_PARSE_HASH_INDEX_SHA224 + CLIAUTH_CONFIG_HASH_SHA224\
+   )
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA384 (\
+      _CLIAUTH_PARSE_HASH_INDEX_SHA256 + CLIAUTH_CONFIG_HASH_SHA256\
+   )
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA512 (\
+      _CLIAUTH_PARSE_HASH_INDEX_SHA384 + CLIAUTH_CONFIG_HASH_SHA384\
+   )
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA512_224 (\
+      _CLIAUTH_PARSE_HASH_INDEX_SHA512 + CLIAUTH_CONFIG_HASH_SHA512\
+   )
+#define _CLIAUTH_PARSE_HASH_INDEX_SHA512_256 (\
+      _CLIAUTH_PARSE_HASH_INDEX_SHA512_224 + CLIAUTH_CONFIG_HASH_SHA512_224\
+   )
+
 static const struct CliAuthParseHashPayload
 cliauth_parse_hash_payload_list [CLIAUTH_HASH_ENABLED_COUNT] = {
 #if CLIAUTH_CONFIG_HASH_SHA1
@@ -229,51 +252,223 @@ cliauth_parse_hash_identifier(
    const char identifier [],
    CliAuthUInt32 identifier_characters
 ) {
-   const struct CliAuthParseHashIdentifier * identifier_iter;
-   const struct CliAuthParseHashPayload * payload_iter;
-   CliAuthUInt8 i;
+   CliAuthUInt8 index;
 
-   identifier_iter = cliauth_parse_hash_identifier_list;
-   payload_iter = cliauth_parse_hash_payload_list;
-   i = CLIAUTH_HASH_ENABLED_COUNT;
+   /* every identifier can be told apart by its length and a single */
+   /* character, so only the one candidate needs to be compared in full */
+   switch (identifier_characters) {
+#if CLIAUTH_CONFIG_HASH_SHA1
+      /* sha1 */
+      case 4:
+         index = _CLIAUTH_PARSE_HASH_INDEX_SHA1;
+         break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
 
-   while (i != 0) {
-      if (cliauth_parse_hash_identifier_compare(
-         identifier_iter,
-         identifier,
-         identifier_characters
-      ) == CLIAUTH_BOOLEAN_TRUE) {
-         *payload = payload_iter;
-         return CLIAUTH_PARSE_HASH_RESULT_SUCCESS;
-      }
+#if CLIAUTH_CONFIG_HASH_SHA224 ||\
+   CLIAUTH_CONFIG_HASH_SHA256 ||\
+   CLIAUTH_CONFIG_HASH_SHA384 ||\
+   CLIAUTH_CONFIG_HASH_SHA512
+      /* sha224, sha256, sha384, and sha512 */
+      case 6:
+         switch (identifier[4]) {
+#if CLIAUTH_CONFIG_HASH_SHA224
+            case '2':
+               index = _CLIAUTH_PARSE_HASH_INDEX_SHA224;
+               break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
+#if CLIAUTH_CONFIG_HASH_SHA256
+            case '5':
+               index = _CLIAUTH_PARSE_HASH_INDEX_SHA256;
+               break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
+#if CLIAUTH_CONFIG_HASH_SHA384
+            case '8':
+               index = _CLIAUTH_PARSE_HASH_INDEX_SHA384;
+               break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
+#if CLIAUTH_CONFIG_HASH_SHA512
+            case '1':
+               index = _CLIAUTH_PARSE_HASH_INDEX_SHA512;
+               break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
+            default:
+               return CLIAUTH_PARSE_HASH_RESULT_UNKNOWN_IDENTIFIER;
+         }
+         break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 || ... */
 
-      identifier_iter++;
-      payload_iter++;
-      i--;
+#if CLIAUTH_CONFIG_HASH_SHA512_224 || CLIAUTH_CONFIG_HASH_SHA512_256
+      /* sha512/224 and sha512/256 */
+      case 10:
+         switch (identifier[9]) {
+#if CLIAUTH_CONFIG_HASH_SHA512_224
+            case '4':
+               index = _CLIAUTH_PARSE_HASH_INDEX_SHA512_224;
+               break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
+#if CLIAUTH_CONFIG_HASH_SHA512_256
+            case '6':
+               index = _CLIAUTH_PARSE_HASH_INDEX_SHA512_256;
+               break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
+            default:
+               return CLIAUTH_PARSE_HASH_RESULT_UNKNOWN_IDENTIFIER;
+         }
+         break;
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 || CLIAUTH_CONFIG_HASH_SHA512_256 */
+
+      default:
+         return CLIAUTH_PARSE_HASH_RESULT_UNKNOWN_IDENTIFIER;
    }
-   
-   return CLIAUTH_PARSE_HASH_RESULT_UNKNOWN_IDENTIFIER;
+
+   if (cliauth_parse_hash_identifier_compare(
+      &cliauth_parse_hash_identifier_list[index],
+      identifier,
+      identifier_characters
+   ) == CLIAUTH_BOOLEAN_FALSE) {
+      return CLIAUTH_PARSE_HASH_RESULT_UNKNOWN_IDENTIFIER;
+   }
+
+   *payload = &cliauth_parse_hash_payload_list[index];
+   return CLIAUTH_PARSE_HASH_RESULT_SUCCESS;
 }
 
-static CliAuthBoolean
-cliauth_parse_base32_is_valid_character(char digit) {
-   if (digit >= 'A' && digit <= 'Z') {
-      return CLIAUTH_BOOLEAN_TRUE;
+/* flags in the base-32 decode table for characters which aren't digits */
+#define _CLIAUTH_PARSE_BASE32_PADDING 0x40
+#define _CLIAUTH_PARSE_BASE32_INVALID 0x80
+#define _CLIAUTH_PARSE_BASE32_FLAGS\
+   (_CLIAUTH_PARSE_BASE32_PADDING | _CLIAUTH_PARSE_BASE32_INVALID)
+
+/* maps every byte to its base-32 digit value, '=' to the padding flag, and */
+/* everything else to the invalid flag, so a single lookup both validates */
+/* and decodes a character */
+static const CliAuthUInt8
+cliauth_parse_base32_decode_table [256] = {
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x00 - 0x07 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x08 - 0x0f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x10 - 0x17 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x18 - 0x1f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x20 - 0x27 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x28 - 0x2f */
+   0x80, 0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,  /* 0x30 - 0x37 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80,  /* 0x38 - 0x3f */
+   0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,  /* 0x40 - 0x47 */
+   0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,  /* 0x48 - 0x4f */
+   0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,  /* 0x50 - 0x57 */
+   0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x58 - 0x5f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x60 - 0x67 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x68 - 0x6f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x70 - 0x77 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x78 - 0x7f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x80 - 0x87 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x88 - 0x8f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x90 - 0x97 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0x98 - 0x9f */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xa0 - 0xa7 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xa8 - 0xaf */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xb0 - 0xb7 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xb8 - 0xbf */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xc0 - 0xc7 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xc8 - 0xcf */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xd0 - 0xd7 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xd8 - 0xdf */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xe0 - 0xe7 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xe8 - 0xef */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,  /* 0xf0 - 0xf7 */
+   0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80   /* 0xf8 - 0xff */
+};
+
+#define _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS 8
+#define _CLIAUTH_PARSE_BASE32_BLOCK_BYTES 5
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+static CliAuthUInt32
+cliauth_parse_base32_decode_blocks_x86(
+   CliAuthUInt8 * output,
+   const char input [],
+   CliAuthUInt32 blocks
+) {
+   CliAuthUInt32 features;
+   CliAuthUInt32 decoded;
+
+   features = cliauth_cpu_x86_features();
+   decoded = 0;
+
+   /* each implementation leaves behind the blocks it can't fill a vector */
+   /* with, so let the next narrower one pick up from there */
+   if ((features & CLIAUTH_CPU_X86_FEATURE_AVX2) != 0) {
+      decoded += cliauth_parse_x86_base32_decode_blocks_avx2(
+         output,
+         input,
+         blocks
+      );
    }
-   if (digit >= '2' && digit <= '7') {
-      return CLIAUTH_BOOLEAN_TRUE;
+   if ((features & CLIAUTH_CPU_X86_FEATURE_SSSE3) != 0) {
+      decoded += cliauth_parse_x86_base32_decode_blocks_ssse3(
+         &output[decoded * _CLIAUTH_PARSE_BASE32_BLOCK_BYTES],
+         &input[decoded * _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS],
+         blocks - decoded
+      );
    }
 
-   return CLIAUTH_BOOLEAN_FALSE;
+   return decoded;
 }
 
-static CliAuthUInt8
-cliauth_parse_base32_digit(char digit) {
-   if (digit >= '2' && digit <= '7') {
-      return digit - '2' + 26;
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/* decodes whole blocks of 8 characters to 5 bytes each, stopping at the */
+/* first block which contains padding or an invalid character, and returns */
+/* the number of blocks decoded */
+static CliAuthUInt32
+cliauth_parse_base32_decode_blocks(
+   CliAuthUInt8 * output,
+   const char * input,
+   CliAuthUInt32 blocks
+) {
+   CliAuthUInt64 block;
+   CliAuthUInt32 decoded;
+   CliAuthUInt8 flags, value;
+   CliAuthUInt8 i;
+
+   decoded = 0;
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+   decoded = cliauth_parse_base32_decode_blocks_x86(output, input, blocks);
+   output += decoded * _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+   input += decoded * _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS;
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+   while (decoded != blocks) {
+      /* look up every character first and check the flags once, since a */
+      /* block with padding or an invalid character is rare */
+      block = 0;
+      flags = 0;
+      i = 0;
+      while (i != _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS) {
+         value = cliauth_parse_base32_decode_table[(CliAuthUInt8)input[i]];
+         block = (block << 5) | value;
+         flags |= value;
+         i++;
+      }
+
+      if ((flags & _CLIAUTH_PARSE_BASE32_FLAGS) != 0) {
+         return decoded;
+      }
+
+      output[0] = (CliAuthUInt8)(block >> 32);
+      output[1] = (CliAuthUInt8)(block >> 24);
+      output[2] = (CliAuthUInt8)(block >> 16);
+      output[3] = (CliAuthUInt8)(block >> 8);
+      output[4] = (CliAuthUInt8)(block);
+
+      output += _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+      input += _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS;
+      decoded++;
    }
 
-   return digit - 'A';
+   return decoded;
 }
 
 static CliAuthUInt16
@@ -300,10 +495,10 @@ cliauth_parse_base32_decode(
 ) {
    CliAuthUInt8 * output_iter;
    const char * input_iter;
+   CliAuthUInt32 blocks;
    CliAuthUInt16 shift_buffer;
    CliAuthUInt8 value; 
    CliAuthUInt8 shift_buffer_bits;
-   char digit;
 
    /* this algorithm basically uses a 16-bit integer to server as a buffer to */
    /* shift and append bits from left to right.  if we have 8 or more bits */
@@ -317,23 +512,39 @@ cliauth_parse_base32_decode(
    *output_bytes = 0;
 
    while (input_characters != 0) {
-      digit = *input_iter;
+      /* whenever the shift buffer is empty, whole blocks of 8 characters */
+      /* line up with whole bytes and can be decoded in bulk instead */
+      blocks = 0;
+      if (shift_buffer_bits == 0) {
+         blocks = cliauth_parse_base32_decode_blocks(
+            output_iter,
+            input_iter,
+            input_characters / _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS
+         );
+      }
+      if (blocks != 0) {
+         output_iter += blocks * _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+         *output_bytes += blocks * _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+         input_iter += blocks * _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS;
+         input_characters -= blocks * _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS;
+         continue;
+      }
+
+      /* parse the character into its integer value */
+      value = cliauth_parse_base32_decode_table[(CliAuthUInt8)*input_iter];
 
       /* check if the character is just padding */
-      if (digit == '=') {
+      if (value == _CLIAUTH_PARSE_BASE32_PADDING) {
          input_iter++;
          input_characters--;
          continue;
       }
 
       /* verify the character is a valid base32 digit */
-      if (cliauth_parse_base32_is_valid_character(digit) == CLIAUTH_BOOLEAN_FALSE) {
+      if (value == _CLIAUTH_PARSE_BASE32_INVALID) {
          return CLIAUTH_PARSE_BASE32_DECODE_RESULT_INVALID_ENCODING;
       }
 
-      /* parse the digit into its integer value */
-      value = cliauth_parse_base32_digit(digit);
-
       /* append the digit bits to the shift buffer */
       shift_buffer |= cliauth_parse_base32_append_shift_buffer(value, shift_buffer_bits);
       shift_buffer_bits += 5;
@@ -358,6 +569,159 @@ cliauth_parse_base32_decode(
    return CLIAUTH_PARSE_BASE32_DECODE_RESULT_SUCCESS;
 }
 
+static const char
+cliauth_parse_base32_encode_alphabet [] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+static CliAuthUInt32
+cliauth_parse_base32_encode_blocks_x86(
+   char output [],
+   const CliAuthUInt8 input [],
+   CliAuthUInt32 blocks
+) {
+   CliAuthUInt32 features;
+   CliAuthUInt32 encoded;
+
+   features = cliauth_cpu_x86_features();
+   encoded = 0;
+
+   if ((features & CLIAUTH_CPU_X86_FEATURE_AVX2) != 0) {
+      encoded += cliauth_parse_x86_base32_encode_blocks_avx2(
+         output,
+         input,
+         blocks
+      );
+   }
+   if ((features & CLIAUTH_CPU_X86_FEATURE_SSSE3) != 0) {
+      encoded += cliauth_parse_x86_base32_encode_blocks_ssse3(
+         &output[encoded * _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS],
+         &input[encoded * _CLIAUTH_PARSE_BASE32_BLOCK_BYTES],
+         blocks - encoded
+      );
+   }
+
+   return encoded;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/* encodes the first 'characters' characters of a block from its 40-bit */
+/* big-endian value */
+static void
+cliauth_parse_base32_encode_block(
+   char output [],
+   CliAuthUInt64 block,
+   CliAuthUInt8 characters
+) {
+   CliAuthUInt8 i;
+
+   i = 0;
+   while (i != characters) {
+      output[i] = cliauth_parse_base32_encode_alphabet[
+         (block >> (35 - (i * 5))) & 0x1f
+      ];
+      i++;
+   }
+
+   return;
+}
+
+/* loads up to 5 bytes of a block as a 40-bit big-endian value, with any */
+/* missing bytes treated as zero */
+static CliAuthUInt64
+cliauth_parse_base32_load_block(
+   const CliAuthUInt8 input [],
+   CliAuthUInt8 bytes
+) {
+   CliAuthUInt64 block;
+   CliAuthUInt8 i;
+
+   block = 0;
+   i = 0;
+   while (i != _CLIAUTH_PARSE_BASE32_BLOCK_BYTES) {
+      block <<= 8;
+      if (i < bytes) {
+         block |= input[i];
+      }
+      i++;
+   }
+
+   return block;
+}
+
+CliAuthUInt32
+cliauth_parse_base32_encode(
+   char output [],
+   const void * input,
+   CliAuthUInt32 input_bytes,
+   CliAuthBoolean padding
+) {
+   const CliAuthUInt8 * input_iter;
+   char * output_iter;
+   CliAuthUInt32 blocks, encoded;
+   CliAuthUInt8 remaining_bytes, remaining_characters;
+
+   input_iter = (const CliAuthUInt8 *)input;
+   output_iter = output;
+
+   blocks = input_bytes / _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+   remaining_bytes = input_bytes % _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+
+   encoded = 0;
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+   encoded = cliauth_parse_base32_encode_blocks_x86(
+      output_iter,
+      input_iter,
+      blocks
+   );
+   output_iter += encoded * _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS;
+   input_iter += encoded * _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+   while (encoded != blocks) {
+      cliauth_parse_base32_encode_block(
+         output_iter,
+         cliauth_parse_base32_load_block(
+            input_iter,
+            _CLIAUTH_PARSE_BASE32_BLOCK_BYTES
+         ),
+         _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS
+      );
+
+      output_iter += _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS;
+      input_iter += _CLIAUTH_PARSE_BASE32_BLOCK_BYTES;
+      encoded++;
+   }
+
+   if (remaining_bytes == 0) {
+      return (CliAuthUInt32)(output_iter - output);
+   }
+
+   /* the final partial block needs enough characters to cover its bits, */
+   /* with the unused low bits of the last character left as zero */
+   remaining_characters = ((remaining_bytes * 8) + 4) / 5;
+
+   cliauth_parse_base32_encode_block(
+      output_iter,
+      cliauth_parse_base32_load_block(input_iter, remaining_bytes),
+      remaining_characters
+   );
+   output_iter += remaining_characters;
+
+   if (padding == CLIAUTH_BOOLEAN_TRUE) {
+      while (remaining_characters != _CLIAUTH_PARSE_BASE32_BLOCK_CHARACTERS) {
+         *output_iter = '=';
+         output_iter++;
+         remaining_characters++;
+      }
+   }
+
+   return (CliAuthUInt32)(output_iter - output);
+}
+
 struct CliAuthParseKeyUriState {
    struct CliAuthParseKeyUriPayload * payload;
    const char * uri_iter;
@@ -1063,6 +1427,14 @@ cliauth_parse_key_uri_query_period(
    return CLIAUTH_PARSE_KEY_URI_RESULT_SUCCESS;
 }
 
+/* the position of each query key in the lists below */
+#define _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_SECRET     0
+#define _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_ISSUER     1
+#define _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_ALGORITHM  2
+#define _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_DIGITS     3
+#define _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_COUNTER    4
+#define _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_PERIOD     5
+
 static const struct CliAuthParseKeyUriQueryKey
 cliauth_parse_key_uri_query_key_identifiers [CLIAUTH_PARSE_KEY_URI_QUERY_KEYS] = {
    {
@@ -1126,29 +1498,54 @@ cliauth_parse_key_uri_query_match_key(
    const char key [],
    CliAuthUInt32 key_characters
 ) {
-   const struct CliAuthParseKeyUriQueryKey * key_iter;
-   const CliAuthParseKeyUriQueryParser * parser_iter;
-   CliAuthUInt8 i;
+   CliAuthUInt8 index;
+
+   /* every key can be told apart by its length and first character, so */
+   /* only the one candidate needs to be compared in full */
+   switch (key_characters) {
+      /* secret, issuer, digits, and period */
+      case 6:
+         switch (key[0]) {
+            case 's':
+               index = _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_SECRET;
+               break;
+            case 'i':
+               index = _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_ISSUER;
+               break;
+            case 'd':
+               index = _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_DIGITS;
+               break;
+            case 'p':
+               index = _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_PERIOD;
+               break;
+            default:
+               return CLIAUTH_NULLPTR;
+         }
+         break;
 
-   key_iter = cliauth_parse_key_uri_query_key_identifiers;
-   parser_iter = cliauth_parse_key_uri_query_key_parsers;
-   i = CLIAUTH_PARSE_KEY_URI_QUERY_KEYS;
+      /* counter */
+      case 7:
+         index = _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_COUNTER;
+         break;
 
-   while (i != 0) {
-      if (cliauth_parse_key_uri_query_key_parsers_identifier_compare(
-         key_iter,
-         key,
-         key_characters
-      ) == CLIAUTH_BOOLEAN_TRUE) {
-         return *parser_iter;
-      }
+      /* algorithm */
+      case 9:
+         index = _CLIAUTH_PARSE_KEY_URI_QUERY_INDEX_ALGORITHM;
+         break;
 
-      key_iter++;
-      parser_iter++;
-      i--;
+      default:
+         return CLIAUTH_NULLPTR;
    }
 
-   return CLIAUTH_NULLPTR;
+   if (cliauth_parse_key_uri_query_key_parsers_identifier_compare(
+      &cliauth_parse_key_uri_query_key_identifiers[index],
+      key,
+      key_characters
+   ) == CLIAUTH_BOOLEAN_FALSE) {
+      return CLIAUTH_NULLPTR;
+   }
+
+   return cliauth_parse_key_uri_query_key_parsers[index];
 }
 
 #define CLIAUTH_PARSE_KEY_URI_QUERY_SENTINEL_SEPERATE '='
@@ -1256,6 +1653,10 @@ cliauth_parse_key_uri(
    struct CliAuthParseKeyUriState state;
    enum CliAuthParseKeyUriResult result;
 
+   if (uri_characters > CLIAUTH_PARSE_KEY_URI_MAX_LENGTH) {
+      return CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_URI;
+   }
+
    /* initialize parser state machine */
    cliauth_parse_key_uri_state_initialize(
       &state,
@@ -164,6 +164,36 @@ cliauth_parse_base32_decode(
    CliAuthUInt32 input_characters
 );
 
+/*----------------------------------------------------------------------------*/
+/* Encodes an array of bytes to an RFC 4648 base-32 ASCII string, using the   */
+/* same upper-case alphabet that cliauth_parse_base32_decode() accepts.       */
+/*----------------------------------------------------------------------------*/
+/* output - A character array to store the resulting string in.  The string   */
+/*          is not null-terminated.  This array must be large enough to store */
+/*          the encoded input bytes.  The required size of this buffer in     */
+/*          characters can be determined with the following formulas:         */
+/*                                                                            */
+/*          without padding = ceil(input bytes * 8 / 5)                       */
+/*          with padding    = ceil(input bytes / 5) * 8                       */
+/*                                                                            */
+/* input - The bytes to be encoded.                                           */
+/*                                                                            */
+/* input_bytes - The length of 'input' in bytes.                              */
+/*                                                                            */
+/* padding - Whether to pad the final group of characters with '=' to a       */
+/*           multiple of 8 characters.  Decoding accepts either form, but     */
+/*           key URIs conventionally leave the padding out.                   */
+/*----------------------------------------------------------------------------*/
+/* Return value - The length of the encoded string in characters.             */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt32
+cliauth_parse_base32_encode(
+   char output [],
+   const void * input,
+   CliAuthUInt32 input_bytes,
+   CliAuthBoolean padding
+);
+
 /*----------------------------------------------------------------------------*/
 /* Return status enum for cliauth_parse_key_uri().                            */
 /*----------------------------------------------------------------------------*/
@@ -234,8 +264,12 @@ cliauth_parse_base32_decode(
 /*                                                                            */
 /* CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_SECRETS - The base-32 secrets string */
 /*                                                 is too long.               */
+/*                                                                            */
+/* CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_URI - The entire key URI is too      */
+/*                                             long.  See                     */
+/*                                             cliauth_parse_key_uri().       */
 /*----------------------------------------------------------------------------*/
-#define CLIAUTH_PARSE_KEY_URI_RESULT_FIELD_COUNT 17
+#define CLIAUTH_PARSE_KEY_URI_RESULT_FIELD_COUNT 18
 enum CliAuthParseKeyUriResult {
    CLIAUTH_PARSE_KEY_URI_RESULT_SUCCESS,
    CLIAUTH_PARSE_KEY_URI_RESULT_MALFORMED_URI,
@@ -253,7 +287,8 @@ enum CliAuthParseKeyUriResult {
    CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_LABEL,
    CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_ISSUER,
    CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_ACCOUNT_NAME,
-   CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_SECRETS
+   CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_SECRETS,
+   CLIAUTH_PARSE_KEY_URI_RESULT_TOO_LONG_URI
 };
 
 /*----------------------------------------------------------------------------*/
@@ -302,6 +337,8 @@ union CliAuthParseKeyUriPayloadAlgorithmParameters {
    struct CliAuthParseKeyUriPayloadAlgorithmParametersTotp totp;
 };
 
+#define CLIAUTH_PARSE_KEY_URI_MAX_LENGTH                       65536
+
 #define CLIAUTH_PARSE_KEY_URI_PAYLOAD_SECRETS_MAX_LENGTH       128
 #define CLIAUTH_PARSE_KEY_URI_PAYLOAD_ISSUER_MAX_LENGTH        64
 #define CLIAUTH_PARSE_KEY_URI_PAYLOAD_ACCOUNT_NAME_MAX_LENGTH  64
@@ -373,7 +410,10 @@ struct CliAuthParseKeyUriPayload {
 /* uri - A string which contains the entire key URI.  The string does not     */
 /*       have to be null-terminated.                                          */
 /*                                                                            */
-/* uri_characters - The length of 'uri' in characters.                        */
+/* uri_characters - The length of 'uri' in characters.  Key URIs longer than  */
+/*                  CLIAUTH_PARSE_KEY_URI_MAX_LENGTH are rejected without     */
+/*                  being parsed, so callers reading them from a stream never */
+/*                  need to buffer more than that.                            */
 /*----------------------------------------------------------------------------*/
 /* Return value - An enum representing the state of the parsed key URI in     */
 /*                'payload'.                                                  */
@@ -0,0 +1,313 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/parse_x86.c - x86-accelerated parsing implementations                  */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "parse_x86.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+#include <immintrin.h>
+
+/* each function is compiled for the extensions it needs, which allows the */
+/* rest of the program to run on CPUs which lack them */
+#define CLIAUTH_PARSE_X86_TARGET(features)\
+   __attribute__((target(features)))
+
+/* decoding works the same way for every vector width, 16 characters at a */
+/* time within each 128-bit lane.  first, characters in 'A'-'Z' and '2'-'7' */
+/* are found with signed compares, which also reject every byte above 0x7f, */
+/* and mapped to their 5-bit values.  pairs of 5-bit values are then merged */
+/* into 10-bit values in 16-bit lanes, pairs of those into 20-bit values in */
+/* 32-bit lanes, and pairs of those into 40-bit values in 64-bit lanes. */
+/* finally, the 5 bytes of each 40-bit value are shuffled into big-endian */
+/* order at the front of the 128-bit lane. */
+
+CLIAUTH_PARSE_X86_TARGET("ssse3")
+CliAuthUInt32
+cliauth_parse_x86_base32_decode_blocks_ssse3(
+   void * output,
+   const char input [],
+   CliAuthUInt32 blocks
+) {
+   CliAuthUInt8 * output_iter;
+   const char * input_iter;
+   CliAuthUInt32 decoded;
+   __m128i characters, alpha, digit, values;
+   __m128i bound_alpha_lower, bound_alpha_upper;
+   __m128i bound_digit_lower, bound_digit_upper;
+   __m128i offset_alpha, offset_digit;
+   __m128i multipliers_pairs, multipliers_quads, mask_lower, shuffle;
+
+   bound_alpha_lower = _mm_set1_epi8('A' - 1);
+   bound_alpha_upper = _mm_set1_epi8('Z' + 1);
+   bound_digit_lower = _mm_set1_epi8('2' - 1);
+   bound_digit_upper = _mm_set1_epi8('7' + 1);
+   offset_alpha = _mm_set1_epi8('A');
+   offset_digit = _mm_set1_epi8('2' - 26);
+   multipliers_pairs = _mm_set1_epi16(0x0120);
+   multipliers_quads = _mm_set1_epi32(0x00010400);
+   mask_lower = _mm_set_epi32(0, -1, 0, -1);
+   shuffle = _mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1);
+
+   output_iter = (CliAuthUInt8 *)output;
+   input_iter = input;
+   decoded = 0;
+
+   while (blocks - decoded >= 2) {
+      characters = _mm_loadu_si128((const __m128i *)input_iter);
+
+      alpha = _mm_and_si128(
+         _mm_cmpgt_epi8(characters, bound_alpha_lower),
+         _mm_cmpgt_epi8(bound_alpha_upper, characters)
+      );
+      digit = _mm_and_si128(
+         _mm_cmpgt_epi8(characters, bound_digit_lower),
+         _mm_cmpgt_epi8(bound_digit_upper, characters)
+      );
+
+      if (_mm_movemask_epi8(_mm_or_si128(alpha, digit)) != 0xffff) {
+         return decoded;
+      }
+
+      values = _mm_or_si128(
+         _mm_and_si128(alpha, _mm_sub_epi8(characters, offset_alpha)),
+         _mm_and_si128(digit, _mm_sub_epi8(characters, offset_digit))
+      );
+
+      values = _mm_maddubs_epi16(values, multipliers_pairs);
+      values = _mm_madd_epi16(values, multipliers_quads);
+      values = _mm_or_si128(
+         _mm_slli_epi64(_mm_and_si128(values, mask_lower), 20),
+         _mm_srli_epi64(values, 32)
+      );
+      values = _mm_shuffle_epi8(values, shuffle);
+
+      _mm_storel_epi64((__m128i *)output_iter, values);
+      output_iter[8] = (CliAuthUInt8)_mm_extract_epi16(values, 4);
+      output_iter[9] = (CliAuthUInt8)(_mm_extract_epi16(values, 4) >> 8);
+
+      output_iter += 10;
+      input_iter += 16;
+      decoded += 2;
+   }
+
+   return decoded;
+}
+
+CLIAUTH_PARSE_X86_TARGET("avx2")
+CliAuthUInt32
+cliauth_parse_x86_base32_decode_blocks_avx2(
+   void * output,
+   const char input [],
+   CliAuthUInt32 blocks
+) {
+   CliAuthUInt8 * output_iter;
+   const char * input_iter;
+   CliAuthUInt32 decoded;
+   __m256i characters, alpha, digit, values;
+   __m256i bound_alpha_lower, bound_alpha_upper;
+   __m256i bound_digit_lower, bound_digit_upper;
+   __m256i offset_alpha, offset_digit;
+   __m256i multipliers_pairs, multipliers_quads, mask_lower, shuffle;
+   __m128i values_lower, values_upper;
+
+   bound_alpha_lower = _mm256_set1_epi8('A' - 1);
+   bound_alpha_upper = _mm256_set1_epi8('Z' + 1);
+   bound_digit_lower = _mm256_set1_epi8('2' - 1);
+   bound_digit_upper = _mm256_set1_epi8('7' + 1);
+   offset_alpha = _mm256_set1_epi8('A');
+   offset_digit = _mm256_set1_epi8('2' - 26);
+   multipliers_pairs = _mm256_set1_epi16(0x0120);
+   multipliers_quads = _mm256_set1_epi32(0x00010400);
+   mask_lower = _mm256_set_epi32(0, -1, 0, -1, 0, -1, 0, -1);
+   shuffle = _mm256_setr_epi8(
+      4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1,
+      4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1, -1
+   );
+
+   output_iter = (CliAuthUInt8 *)output;
+   input_iter = input;
+   decoded = 0;
+
+   while (blocks - decoded >= 4) {
+      characters = _mm256_loadu_si256((const __m256i *)input_iter);
+
+      alpha = _mm256_and_si256(
+         _mm256_cmpgt_epi8(characters, bound_alpha_lower),
+         _mm256_cmpgt_epi8(bound_alpha_upper, characters)
+      );
+      digit = _mm256_and_si256(
+         _mm256_cmpgt_epi8(characters, bound_digit_lower),
+         _mm256_cmpgt_epi8(bound_digit_upper, characters)
+      );
+
+      if (_mm256_movemask_epi8(_mm256_or_si256(alpha, digit)) != -1) {
+         return decoded;
+      }
+
+      values = _mm256_or_si256(
+         _mm256_and_si256(alpha, _mm256_sub_epi8(characters, offset_alpha)),
+         _mm256_and_si256(digit, _mm256_sub_epi8(characters, offset_digit))
+      );
+
+      values = _mm256_maddubs_epi16(values, multipliers_pairs);
+      values = _mm256_madd_epi16(values, multipliers_quads);
+      values = _mm256_or_si256(
+         _mm256_slli_epi64(_mm256_and_si256(values, mask_lower), 20),
+         _mm256_srli_epi64(values, 32)
+      );
+      values = _mm256_shuffle_epi8(values, shuffle);
+
+      values_lower = _mm256_castsi256_si128(values);
+      values_upper = _mm256_extracti128_si256(values, 1);
+
+      _mm_storel_epi64((__m128i *)output_iter, values_lower);
+      output_iter[8] = (CliAuthUInt8)_mm_extract_epi16(values_lower, 4);
+      output_iter[9] = (CliAuthUInt8)(_mm_extract_epi16(values_lower, 4) >> 8);
+
+      _mm_storel_epi64((__m128i *)(output_iter + 10), values_upper);
+      output_iter[18] = (CliAuthUInt8)_mm_extract_epi16(values_upper, 4);
+      output_iter[19] = (CliAuthUInt8)(_mm_extract_epi16(values_upper, 4) >> 8);
+
+      output_iter += 20;
+      input_iter += 32;
+      decoded += 4;
+   }
+
+   return decoded;
+}
+
+/* loads exactly 10 bytes into the bottom of a vector, so encoding never */
+/* reads past the end of the input */
+CLIAUTH_PARSE_X86_TARGET("sse2")
+static __m128i
+cliauth_parse_x86_base32_load_blocks_pair(const CliAuthUInt8 * input) {
+   __m128i bytes;
+
+   bytes = _mm_loadl_epi64((const __m128i *)input);
+   bytes = _mm_insert_epi16(bytes, input[8] | (input[9] << 8), 4);
+
+   return bytes;
+}
+
+/* encoding is decoding in reverse, 10 bytes at a time within each 128-bit */
+/* lane.  the 5 bytes of each block are shuffled into a 40-bit value in a */
+/* 64-bit lane, which is split into 20-bit values in 32-bit lanes, 10-bit */
+/* values in 16-bit lanes, and finally 5-bit values in bytes.  values from */
+/* 26 upwards are then moved from the letters over to the digits '2'-'7'. */
+
+#define CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(prefix, suffix, values, bits, width, mask_lower)\
+   prefix##_or_##suffix(\
+      prefix##_and_##suffix(prefix##_srli_epi##width((values), (bits)), (mask_lower)),\
+      prefix##_slli_epi##width(prefix##_and_##suffix((values), (mask_lower)), (width) / 2)\
+   )
+
+CLIAUTH_PARSE_X86_TARGET("ssse3")
+CliAuthUInt32
+cliauth_parse_x86_base32_encode_blocks_ssse3(
+   char output [],
+   const void * input,
+   CliAuthUInt32 blocks
+) {
+   char * output_iter;
+   const CliAuthUInt8 * input_iter;
+   CliAuthUInt32 encoded;
+   __m128i values, digits;
+   __m128i shuffle, mask_20, mask_10, mask_5;
+   __m128i bound_alpha, offset_alpha, offset_digit;
+
+   shuffle = _mm_setr_epi8(4, 3, 2, 1, 0, -1, -1, -1, 9, 8, 7, 6, 5, -1, -1, -1);
+   mask_20 = _mm_set1_epi64x(0x00000000000fffff);
+   mask_10 = _mm_set1_epi32(0x000003ff);
+   mask_5 = _mm_set1_epi16(0x001f);
+   bound_alpha = _mm_set1_epi8(25);
+   offset_alpha = _mm_set1_epi8('A');
+   offset_digit = _mm_set1_epi8('2' - 26 - 'A');
+
+   output_iter = output;
+   input_iter = (const CliAuthUInt8 *)input;
+   encoded = 0;
+
+   while (blocks - encoded >= 2) {
+      values = cliauth_parse_x86_base32_load_blocks_pair(input_iter);
+      values = _mm_shuffle_epi8(values, shuffle);
+
+      values = CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(_mm, si128, values, 20, 64, mask_20);
+      values = CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(_mm, si128, values, 10, 32, mask_10);
+      values = CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(_mm, si128, values, 5, 16, mask_5);
+
+      digits = _mm_and_si128(_mm_cmpgt_epi8(values, bound_alpha), offset_digit);
+      values = _mm_add_epi8(_mm_add_epi8(values, offset_alpha), digits);
+
+      _mm_storeu_si128((__m128i *)output_iter, values);
+
+      output_iter += 16;
+      input_iter += 10;
+      encoded += 2;
+   }
+
+   return encoded;
+}
+
+CLIAUTH_PARSE_X86_TARGET("avx2")
+CliAuthUInt32
+cliauth_parse_x86_base32_encode_blocks_avx2(
+   char output [],
+   const void * input,
+   CliAuthUInt32 blocks
+) {
+   char * output_iter;
+   const CliAuthUInt8 * input_iter;
+   CliAuthUInt32 encoded;
+   __m256i values, digits;
+   __m256i shuffle, mask_20, mask_10, mask_5;
+   __m256i bound_alpha, offset_alpha, offset_digit;
+
+   shuffle = _mm256_setr_epi8(
+      4, 3, 2, 1, 0, -1, -1, -1, 9, 8, 7, 6, 5, -1, -1, -1,
+      4, 3, 2, 1, 0, -1, -1, -1, 9, 8, 7, 6, 5, -1, -1, -1
+   );
+   mask_20 = _mm256_set1_epi64x(0x00000000000fffff);
+   mask_10 = _mm256_set1_epi32(0x000003ff);
+   mask_5 = _mm256_set1_epi16(0x001f);
+   bound_alpha = _mm256_set1_epi8(25);
+   offset_alpha = _mm256_set1_epi8('A');
+   offset_digit = _mm256_set1_epi8('2' - 26 - 'A');
+
+   output_iter = output;
+   input_iter = (const CliAuthUInt8 *)input;
+   encoded = 0;
+
+   while (blocks - encoded >= 4) {
+      values = _mm256_inserti128_si256(
+         _mm256_castsi128_si256(cliauth_parse_x86_base32_load_blocks_pair(input_iter)),
+         cliauth_parse_x86_base32_load_blocks_pair(input_iter + 10),
+         1
+      );
+      values = _mm256_shuffle_epi8(values, shuffle);
+
+      values = CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(_mm256, si256, values, 20, 64, mask_20);
+      values = CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(_mm256, si256, values, 10, 32, mask_10);
+      values = CLIAUTH_PARSE_X86_BASE32_ENCODE_SPLIT(_mm256, si256, values, 5, 16, mask_5);
+
+      digits = _mm256_and_si256(_mm256_cmpgt_epi8(values, bound_alpha), offset_digit);
+      values = _mm256_add_epi8(_mm256_add_epi8(values, offset_alpha), digits);
+
+      _mm256_storeu_si256((__m256i *)output_iter, values);
+
+      output_iter += 32;
+      input_iter += 20;
+      encoded += 4;
+   }
+
+   return encoded;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
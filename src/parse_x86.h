@@ -0,0 +1,91 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/parse_x86.h - Header for x86-accelerated parsing functions             */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_PARSE_X86_H
+#define _CLIAUTH_PARSE_X86_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+
+#if CLIAUTH_CONFIG_X86_EXTENSIONS
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* The functions in this header are the bulk base-32 codecs used internally   */
+/* by the parser.  Each one requires the CPU features listed in its name,     */
+/* which must be verified with cliauth_cpu_x86_features() before calling it.  */
+/*                                                                            */
+/* Base-32 is handled in blocks of 8 characters and 5 bytes, which are the    */
+/* smallest units that map onto each other without any leftover bits.  Each   */
+/* function handles as many blocks at once as its vector width allows, so     */
+/* the final few blocks may be left for the caller to handle.                 */
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* Decodes blocks of 8 upper-case RFC 4648 base-32 characters to 5 bytes      */
+/* each, stopping early at the first group of blocks which contains padding   */
+/* or an invalid character.  The SSSE3 implementation decodes 2 blocks at a   */
+/* time, and the AVX2 implementation decodes 4 blocks at a time.              */
+/*----------------------------------------------------------------------------*/
+/* output - The array to store 5 bytes to for every decoded block.            */
+/*                                                                            */
+/* input - The characters to decode, which must contain at least 8 characters */
+/*         for every block.                                                   */
+/*                                                                            */
+/* blocks - The number of blocks available in 'input'.                        */
+/*----------------------------------------------------------------------------*/
+/* Return value - The number of blocks which were decoded.                    */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt32
+cliauth_parse_x86_base32_decode_blocks_ssse3(
+   void * output,
+   const char input [],
+   CliAuthUInt32 blocks
+);
+
+CliAuthUInt32
+cliauth_parse_x86_base32_decode_blocks_avx2(
+   void * output,
+   const char input [],
+   CliAuthUInt32 blocks
+);
+
+/*----------------------------------------------------------------------------*/
+/* Encodes blocks of 5 bytes to 8 upper-case RFC 4648 base-32 characters      */
+/* each.  The SSSE3 implementation encodes 2 blocks at a time, and the AVX2   */
+/* implementation encodes 4 blocks at a time.  No bytes are read past the     */
+/* last block.                                                                */
+/*----------------------------------------------------------------------------*/
+/* output - The array to store 8 characters to for every encoded block.       */
+/*                                                                            */
+/* input - The bytes to encode, which must contain at least 5 bytes for every */
+/*         block.                                                             */
+/*                                                                            */
+/* blocks - The number of blocks available in 'input'.                        */
+/*----------------------------------------------------------------------------*/
+/* Return value - The number of blocks which were encoded.                    */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt32
+cliauth_parse_x86_base32_encode_blocks_ssse3(
+   char output [],
+   const void * input,
+   CliAuthUInt32 blocks
+);
+
+CliAuthUInt32
+cliauth_parse_x86_base32_encode_blocks_avx2(
+   char output [],
+   const void * input,
+   CliAuthUInt32 blocks
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_X86_EXTENSIONS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_PARSE_X86_H */
+
@@ -0,0 +1,316 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/pool.c - Work-stealing thread pool implementation.                     */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "pool.h"
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+#include <unistd.h>
+
+CliAuthUInt32
+cliauth_pool_workers_online(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+   long processors;
+
+   processors = sysconf(_SC_NPROCESSORS_ONLN);
+   if (processors < 1) {
+      return 1;
+   }
+   if (processors > CLIAUTH_POOL_WORKERS_MAX) {
+      return CLIAUTH_POOL_WORKERS_MAX;
+   }
+
+   return (CliAuthUInt32)processors;
+#else /* _SC_NPROCESSORS_ONLN */
+   return 1;
+#endif /* _SC_NPROCESSORS_ONLN */
+}
+
+/* takes the next chunk from the front of the worker's own range, returning */
+/* the number of indices taken */
+static CliAuthUInt64
+cliauth_pool_take(
+   struct CliAuthPoolWorker * worker,
+   CliAuthUInt64 * index_first
+) {
+   CliAuthUInt64 index_count;
+
+   cliauth_thread_mutex_lock(&worker->mutex);
+
+   index_count = worker->index_end - worker->index_next;
+   if (index_count > worker->pool->index_chunk) {
+      index_count = worker->pool->index_chunk;
+   }
+
+   *index_first = worker->index_next;
+   worker->index_next += index_count;
+
+   cliauth_thread_mutex_unlock(&worker->mutex);
+
+   return index_count;
+}
+
+/* moves the back half of another worker's remaining range into the worker's */
+/* own range.  the worker's own range must be empty. */
+static CliAuthBoolean
+cliauth_pool_steal(
+   struct CliAuthPoolWorker * worker
+) {
+   struct CliAuthPool * pool;
+   struct CliAuthPoolWorker * victim;
+   CliAuthUInt64 index_remaining, index_split, index_end;
+   CliAuthUInt32 offset;
+
+   pool = worker->pool;
+
+   offset = 1;
+   while (offset < pool->workers_count) {
+      victim = &pool->workers[
+         ((CliAuthUInt32)(worker - pool->workers) + offset) % pool->workers_count
+      ];
+
+      cliauth_thread_mutex_lock(&victim->mutex);
+
+      index_remaining = victim->index_end - victim->index_next;
+
+      /* leave a lone chunk for its owner, which is likely already close to */
+      /* running it */
+      index_split = victim->index_next + (index_remaining / 2);
+      if (index_remaining <= pool->index_chunk) {
+         index_split = victim->index_end;
+      }
+
+      index_end = victim->index_end;
+      victim->index_end = index_split;
+
+      cliauth_thread_mutex_unlock(&victim->mutex);
+
+      if (index_split != index_end) {
+         cliauth_thread_mutex_lock(&worker->mutex);
+         worker->index_next = index_split;
+         worker->index_end = index_end;
+         cliauth_thread_mutex_unlock(&worker->mutex);
+
+         return CLIAUTH_BOOLEAN_TRUE;
+      }
+
+      offset++;
+   }
+
+   return CLIAUTH_BOOLEAN_FALSE;
+}
+
+/* runs chunks until there is no work left to take or steal */
+static void
+cliauth_pool_work(
+   struct CliAuthPoolWorker * worker
+) {
+   struct CliAuthPool * pool;
+   CliAuthUInt64 index_first, index_count;
+   CliAuthBoolean working;
+
+   pool = worker->pool;
+
+   working = CLIAUTH_BOOLEAN_TRUE;
+   while (working == CLIAUTH_BOOLEAN_TRUE) {
+      index_count = cliauth_pool_take(worker, &index_first);
+
+      if (index_count != 0) {
+         pool->function(
+            pool->context,
+            worker->buffers,
+            index_first,
+            index_count
+         );
+      } else {
+         working = cliauth_pool_steal(worker);
+      }
+   }
+
+   return;
+}
+
+/* the entry point of every worker thread, which waits for cliauth_pool_run() */
+/* to hand out new work until the pool is destroyed */
+static void
+cliauth_pool_thread(
+   void * worker_generic
+) {
+   struct CliAuthPoolWorker * worker;
+   struct CliAuthPool * pool;
+
+   worker = (struct CliAuthPoolWorker *)worker_generic;
+   pool = worker->pool;
+
+   cliauth_thread_mutex_lock(&pool->mutex);
+
+   while (pool->stopping == CLIAUTH_BOOLEAN_FALSE) {
+      if (pool->generation == worker->generation) {
+         cliauth_thread_condition_wait(&pool->condition_start, &pool->mutex);
+      } else {
+         worker->generation = pool->generation;
+         cliauth_thread_mutex_unlock(&pool->mutex);
+
+         cliauth_pool_work(worker);
+
+         cliauth_thread_mutex_lock(&pool->mutex);
+         pool->workers_busy--;
+         if (pool->workers_busy == 0) {
+            cliauth_thread_condition_broadcast(&pool->condition_finish);
+         }
+      }
+   }
+
+   cliauth_thread_mutex_unlock(&pool->mutex);
+   return;
+}
+
+/* stops and joins the first 'workers_started' workers, including the calling */
+/* thread's worker which was never started */
+static void
+cliauth_pool_stop(
+   struct CliAuthPool * pool,
+   CliAuthUInt32 workers_started
+) {
+   CliAuthUInt32 i;
+
+   cliauth_thread_mutex_lock(&pool->mutex);
+   pool->stopping = CLIAUTH_BOOLEAN_TRUE;
+   cliauth_thread_condition_broadcast(&pool->condition_start);
+   cliauth_thread_mutex_unlock(&pool->mutex);
+
+   i = 0;
+   while (i != workers_started) {
+      if (i != 0) {
+         cliauth_thread_join(&pool->workers[i].thread);
+      }
+      cliauth_thread_mutex_destroy(&pool->workers[i].mutex);
+      i++;
+   }
+
+   cliauth_thread_condition_destroy(&pool->condition_finish);
+   cliauth_thread_condition_destroy(&pool->condition_start);
+   cliauth_thread_mutex_destroy(&pool->mutex);
+
+   return;
+}
+
+CliAuthBoolean
+cliauth_pool_initialize(
+   struct CliAuthPool * pool,
+   struct CliAuthPoolWorker workers [],
+   CliAuthUInt32 workers_count
+) {
+   struct CliAuthPoolWorker * worker;
+   CliAuthUInt32 i;
+
+   pool->workers = workers;
+   pool->workers_count = workers_count;
+   pool->function = CLIAUTH_NULLPTR;
+   pool->context = CLIAUTH_NULLPTR;
+   pool->index_chunk = 1;
+   pool->generation = 0;
+   pool->workers_busy = 0;
+   pool->stopping = CLIAUTH_BOOLEAN_FALSE;
+
+   cliauth_thread_mutex_initialize(&pool->mutex);
+   cliauth_thread_condition_initialize(&pool->condition_start);
+   cliauth_thread_condition_initialize(&pool->condition_finish);
+
+   i = 0;
+   while (i != workers_count) {
+      worker = &workers[i];
+
+      worker->pool = pool;
+      worker->index_next = 0;
+      worker->index_end = 0;
+      worker->generation = 0;
+      cliauth_thread_mutex_initialize(&worker->mutex);
+
+      if (i != 0 && cliauth_thread_create(
+         &worker->thread,
+         cliauth_pool_thread,
+         worker
+      ) == CLIAUTH_BOOLEAN_FALSE) {
+         cliauth_thread_mutex_destroy(&worker->mutex);
+         cliauth_pool_stop(pool, i);
+         return CLIAUTH_BOOLEAN_FALSE;
+      }
+
+      i++;
+   }
+
+   return CLIAUTH_BOOLEAN_TRUE;
+}
+
+void
+cliauth_pool_destroy(
+   struct CliAuthPool * pool
+) {
+   cliauth_pool_stop(pool, pool->workers_count);
+   return;
+}
+
+void
+cliauth_pool_run(
+   struct CliAuthPool * pool,
+   CliAuthPoolFunction function,
+   void * context,
+   CliAuthUInt64 index_count,
+   CliAuthUInt64 index_chunk
+) {
+   struct CliAuthPoolWorker * worker;
+   CliAuthUInt64 index_share, index_next;
+   CliAuthUInt32 i;
+
+   /* hand out an even share of whole chunks to every worker up front, so */
+   /* stealing is only needed once the work turns out to be uneven */
+   index_share = (index_count / index_chunk) / pool->workers_count;
+   index_share *= index_chunk;
+
+   index_next = 0;
+   i = 0;
+   while (i != pool->workers_count) {
+      worker = &pool->workers[i];
+
+      cliauth_thread_mutex_lock(&worker->mutex);
+      worker->index_next = index_next;
+      index_next += index_share;
+      if (i == pool->workers_count - 1) {
+         index_next = index_count;
+      }
+      worker->index_end = index_next;
+      cliauth_thread_mutex_unlock(&worker->mutex);
+
+      i++;
+   }
+
+   cliauth_thread_mutex_lock(&pool->mutex);
+   pool->function = function;
+   pool->context = context;
+   pool->index_chunk = index_chunk;
+   pool->workers_busy = pool->workers_count - 1;
+   pool->generation++;
+   cliauth_thread_condition_broadcast(&pool->condition_start);
+   cliauth_thread_mutex_unlock(&pool->mutex);
+
+   cliauth_pool_work(&pool->workers[0]);
+
+   cliauth_thread_mutex_lock(&pool->mutex);
+   while (pool->workers_busy != 0) {
+      cliauth_thread_condition_wait(&pool->condition_finish, &pool->mutex);
+   }
+   cliauth_thread_mutex_unlock(&pool->mutex);
+
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
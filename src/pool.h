@@ -0,0 +1,157 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/pool.h - Work-stealing thread pool header.                             */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_POOL_H
+#define _CLIAUTH_POOL_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+#include "hash.h"
+#include "otp.h"
+#include "thread.h"
+
+/*----------------------------------------------------------------------------*/
+/* The maximum number of workers a pool can be sized for by                   */
+/* cliauth_pool_workers_online().                                             */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_POOL_WORKERS_MAX 64
+
+/*----------------------------------------------------------------------------*/
+/* A piece of work run by a pool worker.                                      */
+/*----------------------------------------------------------------------------*/
+/* context - The pointer given to cliauth_pool_run().                         */
+/*                                                                            */
+/* buffers - CLIAUTH_HASH_LANES_MAX scratch buffers which belong to the       */
+/*           calling worker, one for each hash lane.  These are never shared  */
+/*           with other workers, but their contents are not preserved between */
+/*           calls.                                                           */
+/*                                                                            */
+/* index_first - The first index of the work to run.                          */
+/*                                                                            */
+/* index_count - The number of consecutive indices to run, starting from      */
+/*               'index_first'.  This is never zero.                          */
+/*----------------------------------------------------------------------------*/
+typedef void (*CliAuthPoolFunction)(
+   void * context,
+   struct CliAuthOtpBuffersGeneric buffers [],
+   CliAuthUInt64 index_first,
+   CliAuthUInt64 index_count
+);
+
+/*----------------------------------------------------------------------------*/
+/* A single worker of a pool.  The members should be treated as private.      */
+/*----------------------------------------------------------------------------*/
+struct CliAuthPoolWorker {
+   struct CliAuthOtpBuffersGeneric buffers [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthThread thread;
+   struct CliAuthThreadMutex mutex;
+   struct CliAuthPool * pool;
+   CliAuthUInt64 index_next;
+   CliAuthUInt64 index_end;
+   CliAuthUInt32 generation;
+};
+
+/*----------------------------------------------------------------------------*/
+/* A pool of workers which split up ranges of indices between themselves.     */
+/* Each worker owns a range of indices, which it runs in chunks from the      */
+/* front.  Once a worker runs out, it steals the back half of another         */
+/* worker's remaining range, so uneven work still spreads out across every    */
+/* worker.  The members should be treated as private.                         */
+/*----------------------------------------------------------------------------*/
+struct CliAuthPool {
+   struct CliAuthPoolWorker * workers;
+   CliAuthUInt32 workers_count;
+   struct CliAuthThreadMutex mutex;
+   struct CliAuthThreadCondition condition_start;
+   struct CliAuthThreadCondition condition_finish;
+   CliAuthPoolFunction function;
+   void * context;
+   CliAuthUInt64 index_chunk;
+   CliAuthUInt32 generation;
+   CliAuthUInt32 workers_busy;
+   CliAuthBoolean stopping;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Gets the number of processors which are currently online, to use as the    */
+/* number of workers in a pool.                                               */
+/*----------------------------------------------------------------------------*/
+/* Return value - The number of online processors, clamped between 1 and      */
+/*                CLIAUTH_POOL_WORKERS_MAX.  If the number can't be           */
+/*                determined, this is 1.                                      */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt32
+cliauth_pool_workers_online(void);
+
+/*----------------------------------------------------------------------------*/
+/* Initializes a pool and starts its worker threads.  The calling thread is   */
+/* always the first worker, so 'workers_count' - 1 threads are started.       */
+/*----------------------------------------------------------------------------*/
+/* pool - The pool to initialize.                                             */
+/*                                                                            */
+/* workers - An array of 'workers_count' workers, which must stay valid until */
+/*           the pool is destroyed.                                           */
+/*                                                                            */
+/* workers_count - The number of workers, which must be at least 1.           */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if every worker thread was started.    */
+/*                Otherwise CLIAUTH_BOOLEAN_FALSE, in which case any started  */
+/*                threads are stopped again and the pool must not be used.    */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_pool_initialize(
+   struct CliAuthPool * pool,
+   struct CliAuthPoolWorker workers [],
+   CliAuthUInt32 workers_count
+);
+
+/*----------------------------------------------------------------------------*/
+/* Stops the worker threads of a pool and releases its resources.             */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_pool_destroy(
+   struct CliAuthPool * pool
+);
+
+/*----------------------------------------------------------------------------*/
+/* Runs a function over every index from 0 to 'index_count' - 1 across all    */
+/* workers, returning once every index has been run.  Indices are handed out  */
+/* in order within each worker, but different workers run at the same time,   */
+/* so 'function' must only write to memory which belongs to its own indices.  */
+/*----------------------------------------------------------------------------*/
+/* pool - The pool to run on.  This must only be used by one thread at a      */
+/*        time.                                                               */
+/*                                                                            */
+/* function - The function to run.                                            */
+/*                                                                            */
+/* context - Passed as-is to 'function'.                                      */
+/*                                                                            */
+/* index_count - The number of indices to run.                                */
+/*                                                                            */
+/* index_chunk - The largest number of indices given to a single call of      */
+/*               'function'.  This must be at least 1.  Larger chunks have    */
+/*               less overhead, while smaller chunks balance better.          */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_pool_run(
+   struct CliAuthPool * pool,
+   CliAuthPoolFunction function,
+   void * context,
+   CliAuthUInt64 index_count,
+   CliAuthUInt64 index_chunk
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_POOL_H */
+
@@ -0,0 +1,140 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/thread.c - Thin wrappers around POSIX threads implementation.          */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "thread.h"
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+#include <time.h>
+
+/* adapts the pthread entry point signature to CliAuthThreadFunction */
+static void *
+cliauth_thread_entry(void * thread_generic) {
+   struct CliAuthThread * thread;
+
+   thread = (struct CliAuthThread *)thread_generic;
+   thread->function(thread->context);
+
+   return CLIAUTH_NULLPTR;
+}
+
+CliAuthBoolean
+cliauth_thread_create(
+   struct CliAuthThread * thread,
+   CliAuthThreadFunction function,
+   void * context
+) {
+   thread->function = function;
+   thread->context = context;
+
+   if (pthread_create(
+      &thread->handle,
+      CLIAUTH_NULLPTR,
+      cliauth_thread_entry,
+      thread
+   ) != 0) {
+      return CLIAUTH_BOOLEAN_FALSE;
+   }
+
+   return CLIAUTH_BOOLEAN_TRUE;
+}
+
+void
+cliauth_thread_join(
+   struct CliAuthThread * thread
+) {
+   (void)pthread_join(thread->handle, CLIAUTH_NULLPTR);
+   return;
+}
+
+void
+cliauth_thread_mutex_initialize(
+   struct CliAuthThreadMutex * mutex
+) {
+   (void)pthread_mutex_init(&mutex->handle, CLIAUTH_NULLPTR);
+   return;
+}
+
+void
+cliauth_thread_mutex_destroy(
+   struct CliAuthThreadMutex * mutex
+) {
+   (void)pthread_mutex_destroy(&mutex->handle);
+   return;
+}
+
+void
+cliauth_thread_mutex_lock(
+   struct CliAuthThreadMutex * mutex
+) {
+   (void)pthread_mutex_lock(&mutex->handle);
+   return;
+}
+
+void
+cliauth_thread_mutex_unlock(
+   struct CliAuthThreadMutex * mutex
+) {
+   (void)pthread_mutex_unlock(&mutex->handle);
+   return;
+}
+
+void
+cliauth_thread_condition_initialize(
+   struct CliAuthThreadCondition * condition
+) {
+   (void)pthread_cond_init(&condition->handle, CLIAUTH_NULLPTR);
+   return;
+}
+
+void
+cliauth_thread_condition_destroy(
+   struct CliAuthThreadCondition * condition
+) {
+   (void)pthread_cond_destroy(&condition->handle);
+   return;
+}
+
+void
+cliauth_thread_condition_broadcast(
+   struct CliAuthThreadCondition * condition
+) {
+   (void)pthread_cond_broadcast(&condition->handle);
+   return;
+}
+
+void
+cliauth_thread_condition_wait(
+   struct CliAuthThreadCondition * condition,
+   struct CliAuthThreadMutex * mutex
+) {
+   (void)pthread_cond_wait(&condition->handle, &mutex->handle);
+   return;
+}
+
+void
+cliauth_thread_condition_wait_until(
+   struct CliAuthThreadCondition * condition,
+   struct CliAuthThreadMutex * mutex,
+   CliAuthUInt64 time_deadline
+) {
+   struct timespec deadline;
+
+   /* condition variables use the realtime clock by default, which counts */
+   /* from the Unix epoch */
+   deadline.tv_sec = (time_t)time_deadline;
+   deadline.tv_nsec = 0;
+
+   (void)pthread_cond_timedwait(&condition->handle, &mutex->handle, &deadline);
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
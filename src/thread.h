@@ -0,0 +1,149 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/thread.h - Thin wrappers around POSIX threads header.                  */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_THREAD_H
+#define _CLIAUTH_THREAD_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+#include <pthread.h>
+
+/*----------------------------------------------------------------------------*/
+/* The entry point of a thread.                                               */
+/*----------------------------------------------------------------------------*/
+/* context - The pointer given to cliauth_thread_create().                    */
+/*----------------------------------------------------------------------------*/
+typedef void (*CliAuthThreadFunction)(
+   void * context
+);
+
+struct CliAuthThread {
+   pthread_t handle;
+   CliAuthThreadFunction function;
+   void * context;
+};
+
+struct CliAuthThreadMutex {
+   pthread_mutex_t handle;
+};
+
+struct CliAuthThreadCondition {
+   pthread_cond_t handle;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Starts a new thread.                                                       */
+/*----------------------------------------------------------------------------*/
+/* thread - The thread to start.  This must stay valid until the thread is    */
+/*          joined with cliauth_thread_join().                                */
+/*                                                                            */
+/* function - The function to run on the new thread.                          */
+/*                                                                            */
+/* context - Passed as-is to 'function'.                                      */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if the thread was started, otherwise   */
+/*                CLIAUTH_BOOLEAN_FALSE.                                      */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_thread_create(
+   struct CliAuthThread * thread,
+   CliAuthThreadFunction function,
+   void * context
+);
+
+/*----------------------------------------------------------------------------*/
+/* Waits for a thread started with cliauth_thread_create() to return.         */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_thread_join(
+   struct CliAuthThread * thread
+);
+
+void
+cliauth_thread_mutex_initialize(
+   struct CliAuthThreadMutex * mutex
+);
+
+void
+cliauth_thread_mutex_destroy(
+   struct CliAuthThreadMutex * mutex
+);
+
+void
+cliauth_thread_mutex_lock(
+   struct CliAuthThreadMutex * mutex
+);
+
+void
+cliauth_thread_mutex_unlock(
+   struct CliAuthThreadMutex * mutex
+);
+
+void
+cliauth_thread_condition_initialize(
+   struct CliAuthThreadCondition * condition
+);
+
+void
+cliauth_thread_condition_destroy(
+   struct CliAuthThreadCondition * condition
+);
+
+/*----------------------------------------------------------------------------*/
+/* Wakes every thread waiting on a condition.                                 */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_thread_condition_broadcast(
+   struct CliAuthThreadCondition * condition
+);
+
+/*----------------------------------------------------------------------------*/
+/* Waits on a condition until it is signaled.  Like all condition waits, this */
+/* may also return early for no reason, so the caller must re-check what it   */
+/* is waiting for.                                                            */
+/*----------------------------------------------------------------------------*/
+/* condition - The condition to wait on.                                      */
+/*                                                                            */
+/* mutex - A mutex which is locked by the calling thread.  It is unlocked     */
+/*         while waiting and locked again before returning.                   */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_thread_condition_wait(
+   struct CliAuthThreadCondition * condition,
+   struct CliAuthThreadMutex * mutex
+);
+
+/*----------------------------------------------------------------------------*/
+/* Waits on a condition until it is signaled or a deadline passes.  Like all  */
+/* condition waits, this may also return early for no reason, so the caller   */
+/* must re-check what it is waiting for.                                      */
+/*----------------------------------------------------------------------------*/
+/* condition - The condition to wait on.                                      */
+/*                                                                            */
+/* mutex - A mutex which is locked by the calling thread.  It is unlocked     */
+/*         while waiting and locked again before returning.                   */
+/*                                                                            */
+/* time_deadline - The time to stop waiting at, in seconds relative to the    */
+/*                 Unix epoch.                                                */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_thread_condition_wait_until(
+   struct CliAuthThreadCondition * condition,
+   struct CliAuthThreadMutex * mutex,
+   CliAuthUInt64 time_deadline
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_THREAD_H */
+
@@ -0,0 +1,804 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/verify.c - One-time-password verification helpers implementation.      */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "verify.h"
+
+#include <string.h>
+#include <time.h>
+#include "hash.h"
+#include "mac.h"
+#include "otp.h"
+#include "thread.h"
+
+/* stored in place of steps which don't exist.  passcodes are always less */
+/* than 10^9, so this never matches */
+#define _CLIAUTH_VERIFY_PASSCODE_NONE ((CliAuthUInt32)0xffffffff)
+
+/* the number of passcode bits sorted by each radix sort pass.  six digit */
+/* passcodes fit in 20 bits, so they take two passes */
+#define _CLIAUTH_VERIFY_INDEX_RADIX_BITS 10
+#define _CLIAUTH_VERIFY_INDEX_RADIX_BUCKETS \
+   ((CliAuthUInt32)1 << _CLIAUTH_VERIFY_INDEX_RADIX_BITS)
+
+/* the number of changed accounts recomputed together on the stack */
+#define _CLIAUTH_VERIFY_INDEX_CHUNK 64
+
+void
+cliauth_verify_cache_initialize(
+   struct CliAuthVerifyCache * cache,
+   struct CliAuthVerifyCacheEntry entries [],
+   CliAuthUInt32 entries_count
+) {
+   CliAuthUInt32 i;
+
+   cache->entries = entries;
+   cache->entries_mask = entries_count - 1;
+
+   i = 0;
+   while (i != entries_count) {
+      entries[i].account = 0;
+      entries[i].valid = CLIAUTH_BOOLEAN_FALSE;
+      i++;
+   }
+
+   return;
+}
+
+void
+cliauth_verify_cache_invalidate(
+   struct CliAuthVerifyCache * cache,
+   CliAuthUInt32 account
+) {
+   struct CliAuthVerifyCacheEntry * entry;
+
+   entry = &cache->entries[account & cache->entries_mask];
+
+   if (entry->account == account) {
+      entry->valid = CLIAUTH_BOOLEAN_FALSE;
+   }
+
+   return;
+}
+
+static void
+cliauth_verify_cache_fill(
+   struct CliAuthVerifyCacheEntry * entry,
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt32 account,
+   CliAuthUInt64 counter,
+   CliAuthUInt8 digits
+) {
+   CliAuthUInt64 counters [CLIAUTH_VERIFY_CACHE_STEPS];
+   CliAuthUInt32 passcodes [CLIAUTH_VERIFY_CACHE_STEPS];
+
+   /* when the step has just rolled over, the old current and next steps */
+   /* become the new previous and current steps */
+   if (
+      entry->valid == CLIAUTH_BOOLEAN_TRUE &&
+      entry->account == account &&
+      entry->digits == digits &&
+      entry->counter + 1 == counter
+   ) {
+      entry->passcodes[0] = entry->passcodes[1];
+      entry->passcodes[1] = entry->passcodes[2];
+
+      counters[0] = counter + 1;
+      cliauth_otp_hotp_multi(
+         hmac_key,
+         hash_contexts,
+         &entry->passcodes[2],
+         counters,
+         1,
+         digits
+      );
+
+      entry->counter = counter;
+      return;
+   }
+
+   if (counter == 0) {
+      counters[0] = counter;
+      counters[1] = counter + 1;
+      cliauth_otp_hotp_multi(
+         hmac_key,
+         hash_contexts,
+         passcodes,
+         counters,
+         2,
+         digits
+      );
+
+      entry->passcodes[0] = _CLIAUTH_VERIFY_PASSCODE_NONE;
+      entry->passcodes[1] = passcodes[0];
+      entry->passcodes[2] = passcodes[1];
+   } else {
+      counters[0] = counter - 1;
+      counters[1] = counter;
+      counters[2] = counter + 1;
+      cliauth_otp_hotp_multi(
+         hmac_key,
+         hash_contexts,
+         entry->passcodes,
+         counters,
+         CLIAUTH_VERIFY_CACHE_STEPS,
+         digits
+      );
+   }
+
+   entry->counter = counter;
+   entry->account = account;
+   entry->digits = digits;
+   entry->valid = CLIAUTH_BOOLEAN_TRUE;
+   return;
+}
+
+CliAuthBoolean
+cliauth_verify_totp_cached(
+   struct CliAuthVerifyCache * cache,
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthSInt64 * step_matched,
+   CliAuthUInt32 account,
+   CliAuthUInt64 time_initial,
+   CliAuthUInt64 time_current,
+   CliAuthUInt64 time_interval,
+   CliAuthUInt32 passcode,
+   CliAuthUInt8 digits
+) {
+   struct CliAuthVerifyCacheEntry * entry;
+   CliAuthUInt64 counter;
+
+   counter = (time_current - time_initial) / time_interval;
+
+   entry = &cache->entries[account & cache->entries_mask];
+
+   if (
+      entry->valid != CLIAUTH_BOOLEAN_TRUE ||
+      entry->account != account ||
+      entry->digits != digits ||
+      entry->counter != counter
+   ) {
+      cliauth_verify_cache_fill(
+         entry,
+         hmac_key,
+         hash_contexts,
+         account,
+         counter,
+         digits
+      );
+   }
+
+   /* checked in order of distance from the current step, preferring the */
+   /* earlier step on a tie, the same as cliauth_otp_totp_verify() */
+   if (entry->passcodes[1] == passcode) {
+      *step_matched = 0;
+      return CLIAUTH_BOOLEAN_TRUE;
+   }
+   if (entry->passcodes[0] == passcode) {
+      *step_matched = -1;
+      return CLIAUTH_BOOLEAN_TRUE;
+   }
+   if (entry->passcodes[2] == passcode) {
+      *step_matched = 1;
+      return CLIAUTH_BOOLEAN_TRUE;
+   }
+
+   return CLIAUTH_BOOLEAN_FALSE;
+}
+
+/* locks out table lookups while the buffers are swapped.  without threads */
+/* there is nothing to lock out */
+static void
+cliauth_verify_table_lock(
+   struct CliAuthVerifyTable * table
+) {
+#if CLIAUTH_CONFIG_THREADS
+   cliauth_thread_mutex_lock(&table->mutex);
+#else /* CLIAUTH_CONFIG_THREADS */
+   (void)table;
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   return;
+}
+
+static void
+cliauth_verify_table_unlock(
+   struct CliAuthVerifyTable * table
+) {
+#if CLIAUTH_CONFIG_THREADS
+   cliauth_thread_mutex_unlock(&table->mutex);
+#else /* CLIAUTH_CONFIG_THREADS */
+   (void)table;
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   return;
+}
+
+/* builds the row for a target step, which holds the passcodes of the */
+/* counters from (counter - 2) to (counter + 1) */
+static void
+cliauth_verify_table_row_build(
+   struct CliAuthVerifyTableRow * row,
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthUInt64 counter,
+   CliAuthUInt8 digits
+) {
+   CliAuthUInt64 counters [CLIAUTH_VERIFY_TABLE_STEPS];
+   CliAuthUInt32 passcodes [CLIAUTH_VERIFY_TABLE_STEPS];
+   CliAuthUInt32 step_first, i;
+
+   row->counter_first = counter - 2;
+
+   /* skip the steps which would be before the initial time */
+   step_first = 0;
+   if (counter < 2) {
+      step_first = 2 - (CliAuthUInt32)counter;
+   }
+
+   i = 0;
+   while (i != CLIAUTH_VERIFY_TABLE_STEPS - step_first) {
+      counters[i] = row->counter_first + step_first + i;
+      i++;
+   }
+
+   cliauth_otp_hotp_multi(
+      hmac_key,
+      hash_contexts,
+      passcodes,
+      counters,
+      CLIAUTH_VERIFY_TABLE_STEPS - step_first,
+      digits
+   );
+
+   i = 0;
+   while (i != CLIAUTH_VERIFY_TABLE_STEPS) {
+      if (i < step_first) {
+         row->passcodes[i] = _CLIAUTH_VERIFY_PASSCODE_NONE;
+      } else {
+         row->passcodes[i] = passcodes[i - step_first];
+      }
+
+      i++;
+   }
+
+   return;
+}
+
+/* builds every row of the back buffer for the given time.  rows which are */
+/* already up-to-date in the front buffer are copied instead */
+static CliAuthUInt64
+cliauth_verify_table_build(
+   struct CliAuthVerifyTable * table,
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current,
+   CliAuthBoolean front_valid
+) {
+   const struct CliAuthOtpTotpTable * accounts;
+   const struct CliAuthVerifyTableRow * rows_front;
+   struct CliAuthVerifyTableRow * rows_back;
+   CliAuthUInt64 time_target, time_boundary, time_boundary_next;
+   CliAuthUInt64 counter;
+   CliAuthUInt32 i;
+
+   accounts = &table->accounts;
+   rows_front = table->rows[table->rows_front];
+   rows_back = table->rows[table->rows_front ^ 1];
+
+   /* rows are built for the step which will be current after the lead */
+   /* time, so they are ready before the boundary is reached */
+   time_target = time_current + table->time_lead;
+   time_boundary_next = ~(CliAuthUInt64)0;
+
+   i = 0;
+   while (i != accounts->count) {
+      counter =
+         (time_target - accounts->time_initial[i]) /
+         accounts->time_interval[i];
+
+      if (
+         front_valid == CLIAUTH_BOOLEAN_TRUE &&
+         rows_front[i].counter_first == counter - 2
+      ) {
+         rows_back[i] = rows_front[i];
+      } else {
+         cliauth_verify_table_row_build(
+            &rows_back[i],
+            &accounts->hmac_keys[i],
+            hash_contexts,
+            counter,
+            accounts->digits[i]
+         );
+      }
+
+      /* each account has its own schedule, so the table is refreshed at */
+      /* the earliest upcoming boundary of any account */
+      time_boundary =
+         accounts->time_initial[i] +
+         ((counter + 1) * accounts->time_interval[i]);
+      if (time_boundary < time_boundary_next) {
+         time_boundary_next = time_boundary;
+      }
+
+      i++;
+   }
+
+   cliauth_verify_table_lock(table);
+   table->rows_front ^= 1;
+   table->time_refresh = time_boundary_next - table->time_lead;
+   cliauth_verify_table_unlock(table);
+
+   return time_boundary_next - table->time_lead;
+}
+
+void
+cliauth_verify_table_initialize(
+   struct CliAuthVerifyTable * table,
+   const struct CliAuthOtpTotpTable * accounts,
+   struct CliAuthVerifyTableRow rows_front [],
+   struct CliAuthVerifyTableRow rows_back [],
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current,
+   CliAuthUInt64 time_lead
+) {
+   table->accounts = *accounts;
+   table->rows[0] = rows_front;
+   table->rows[1] = rows_back;
+   table->rows_front = 0;
+   table->time_lead = time_lead;
+
+#if CLIAUTH_CONFIG_THREADS
+   cliauth_thread_mutex_initialize(&table->mutex);
+   cliauth_thread_condition_initialize(&table->condition);
+   table->stopping = CLIAUTH_BOOLEAN_FALSE;
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   (void)cliauth_verify_table_build(
+      table,
+      hash_contexts,
+      time_current,
+      CLIAUTH_BOOLEAN_FALSE
+   );
+
+   return;
+}
+
+void
+cliauth_verify_table_destroy(
+   struct CliAuthVerifyTable * table
+) {
+#if CLIAUTH_CONFIG_THREADS
+   cliauth_thread_condition_destroy(&table->condition);
+   cliauth_thread_mutex_destroy(&table->mutex);
+#else /* CLIAUTH_CONFIG_THREADS */
+   (void)table;
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+   return;
+}
+
+CliAuthUInt64
+cliauth_verify_table_refresh(
+   struct CliAuthVerifyTable * table,
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current
+) {
+   return cliauth_verify_table_build(
+      table,
+      hash_contexts,
+      time_current,
+      CLIAUTH_BOOLEAN_TRUE
+   );
+}
+
+CliAuthBoolean
+cliauth_verify_table_lookup(
+   struct CliAuthVerifyTable * table,
+   void * const hash_contexts [],
+   CliAuthSInt64 * step_matched,
+   CliAuthUInt32 account,
+   CliAuthUInt64 time_current,
+   CliAuthUInt32 passcode
+) {
+   const struct CliAuthOtpTotpTable * accounts;
+   struct CliAuthVerifyTableRow row;
+   CliAuthUInt64 counter, index;
+
+   accounts = &table->accounts;
+
+   /* copy the row out so the buffers can be swapped while it's checked */
+   cliauth_verify_table_lock(table);
+   row = table->rows[table->rows_front][account];
+   cliauth_verify_table_unlock(table);
+
+   counter =
+      (time_current - accounts->time_initial[account]) /
+      accounts->time_interval[account];
+
+   /* index of the previous step, which wraps around when the row doesn't */
+   /* cover the previous, current, and next steps */
+   index = (counter - 1) - row.counter_first;
+   if (index > CLIAUTH_VERIFY_TABLE_STEPS - 3) {
+      return cliauth_otp_totp_verify(
+         &accounts->hmac_keys[account],
+         hash_contexts,
+         step_matched,
+         accounts->time_initial[account],
+         time_current,
+         accounts->time_interval[account],
+         passcode,
+         1,
+         accounts->digits[account]
+      );
+   }
+
+   /* checked in order of distance from the current step, preferring the */
+   /* earlier step on a tie, the same as cliauth_otp_totp_verify() */
+   if (row.passcodes[index + 1] == passcode) {
+      *step_matched = 0;
+      return CLIAUTH_BOOLEAN_TRUE;
+   }
+   if (row.passcodes[index + 0] == passcode) {
+      *step_matched = -1;
+      return CLIAUTH_BOOLEAN_TRUE;
+   }
+   if (row.passcodes[index + 2] == passcode) {
+      *step_matched = 1;
+      return CLIAUTH_BOOLEAN_TRUE;
+   }
+
+   return CLIAUTH_BOOLEAN_FALSE;
+}
+
+/* sorts entries by passcode with a least-significant-digit radix sort, */
+/* ping-ponging between 'entries' and 'temporary'.  the sorted entries end */
+/* up in 'entries' */
+static void
+cliauth_verify_index_sort(
+   struct CliAuthVerifyIndexEntry entries [],
+   struct CliAuthVerifyIndexEntry temporary [],
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 buckets [_CLIAUTH_VERIFY_INDEX_RADIX_BUCKETS];
+   struct CliAuthVerifyIndexEntry * source;
+   struct CliAuthVerifyIndexEntry * destination;
+   struct CliAuthVerifyIndexEntry * swap;
+   CliAuthUInt32 passcode_max, shift, bucket, offset, i;
+
+   /* only sort as many digits as the largest passcode has */
+   passcode_max = 0;
+   i = 0;
+   while (i != count) {
+      if (entries[i].passcode > passcode_max) {
+         passcode_max = entries[i].passcode;
+      }
+      i++;
+   }
+
+   source = entries;
+   destination = temporary;
+
+   shift = 0;
+   while (shift < 32 && (passcode_max >> shift) != 0) {
+      i = 0;
+      while (i != _CLIAUTH_VERIFY_INDEX_RADIX_BUCKETS) {
+         buckets[i] = 0;
+         i++;
+      }
+
+      i = 0;
+      while (i != count) {
+         bucket = (source[i].passcode >> shift) & (_CLIAUTH_VERIFY_INDEX_RADIX_BUCKETS - 1);
+         buckets[bucket]++;
+         i++;
+      }
+
+      /* convert the counts into starting offsets */
+      offset = 0;
+      i = 0;
+      while (i != _CLIAUTH_VERIFY_INDEX_RADIX_BUCKETS) {
+         bucket = buckets[i];
+         buckets[i] = offset;
+         offset += bucket;
+         i++;
+      }
+
+      i = 0;
+      while (i != count) {
+         bucket = (source[i].passcode >> shift) & (_CLIAUTH_VERIFY_INDEX_RADIX_BUCKETS - 1);
+         destination[buckets[bucket]] = source[i];
+         buckets[bucket]++;
+         i++;
+      }
+
+      swap = source;
+      source = destination;
+      destination = swap;
+
+      shift += _CLIAUTH_VERIFY_INDEX_RADIX_BITS;
+   }
+
+   if (source != entries) {
+      (void)memcpy(entries, source, count * sizeof(*entries));
+   }
+
+   return;
+}
+
+/* computes the passcodes of the accounts listed in the 'account' field of */
+/* 'entries' into the 'passcode' field */
+static void
+cliauth_verify_index_compute(
+   struct CliAuthVerifyIndex * index,
+   void * const hash_contexts [],
+   struct CliAuthVerifyIndexEntry entries [],
+   CliAuthUInt64 time_current,
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 accounts [_CLIAUTH_VERIFY_INDEX_CHUNK];
+   CliAuthUInt32 passcodes [_CLIAUTH_VERIFY_INDEX_CHUNK];
+   CliAuthUInt32 first, chunk, i;
+
+   first = 0;
+   while (first != count) {
+      chunk = count - first;
+      if (chunk > _CLIAUTH_VERIFY_INDEX_CHUNK) {
+         chunk = _CLIAUTH_VERIFY_INDEX_CHUNK;
+      }
+
+      i = 0;
+      while (i != chunk) {
+         accounts[i] = entries[first + i].account;
+         i++;
+      }
+
+      cliauth_otp_totp_table_select(
+         &index->accounts,
+         hash_contexts,
+         accounts,
+         passcodes,
+         time_current,
+         chunk
+      );
+
+      i = 0;
+      while (i != chunk) {
+         entries[first + i].passcode = passcodes[i];
+         i++;
+      }
+
+      first += chunk;
+   }
+
+   return;
+}
+
+void
+cliauth_verify_index_initialize(
+   struct CliAuthVerifyIndex * index,
+   const struct CliAuthOtpTotpTable * accounts,
+   struct CliAuthVerifyIndexEntry entries [],
+   struct CliAuthVerifyIndexEntry entries_scratch [],
+   CliAuthUInt64 counters [],
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current
+) {
+   CliAuthUInt32 i;
+
+   index->accounts = *accounts;
+   index->entries = entries;
+   index->entries_scratch = entries_scratch;
+   index->counters = counters;
+
+   i = 0;
+   while (i != accounts->count) {
+      counters[i] =
+         (time_current - accounts->time_initial[i]) /
+         accounts->time_interval[i];
+      entries[i].account = i;
+      i++;
+   }
+
+   cliauth_verify_index_compute(
+      index,
+      hash_contexts,
+      entries,
+      time_current,
+      accounts->count
+   );
+
+   cliauth_verify_index_sort(entries, entries_scratch, accounts->count);
+
+   return;
+}
+
+void
+cliauth_verify_index_refresh(
+   struct CliAuthVerifyIndex * index,
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current
+) {
+   const struct CliAuthOtpTotpTable * accounts;
+   struct CliAuthVerifyIndexEntry * entries;
+   struct CliAuthVerifyIndexEntry * changed;
+   CliAuthUInt64 counter;
+   CliAuthUInt32 count, kept, changed_count;
+   CliAuthUInt32 account, read, write, i;
+
+   accounts = &index->accounts;
+   entries = index->entries;
+   changed = index->entries_scratch;
+   count = accounts->count;
+
+   /* split the sorted entries into the ones which are still current, which */
+   /* are compacted in order to the front of 'entries', and the accounts */
+   /* which need to be recomputed, which are listed in 'changed' */
+   kept = 0;
+   changed_count = 0;
+   read = 0;
+   while (read != count) {
+      account = entries[read].account;
+      counter =
+         (time_current - accounts->time_initial[account]) /
+         accounts->time_interval[account];
+
+      if (counter == index->counters[account]) {
+         entries[kept] = entries[read];
+         kept++;
+      } else {
+         index->counters[account] = counter;
+         changed[changed_count].account = account;
+         changed_count++;
+      }
+
+      read++;
+   }
+
+   if (changed_count == 0) {
+      return;
+   }
+
+   cliauth_verify_index_compute(
+      index,
+      hash_contexts,
+      changed,
+      time_current,
+      changed_count
+   );
+
+   /* the back of 'entries' is free while sorting */
+   cliauth_verify_index_sort(changed, &entries[kept], changed_count);
+
+   /* merge from the back, so the kept entries are never overwritten */
+   /* before they're read */
+   write = count;
+   read = kept;
+   i = changed_count;
+   while (i != 0) {
+      write--;
+
+      if (read != 0 && entries[read - 1].passcode > changed[i - 1].passcode) {
+         entries[write] = entries[read - 1];
+         read--;
+      } else {
+         entries[write] = changed[i - 1];
+         i--;
+      }
+   }
+
+   return;
+}
+
+CliAuthUInt32
+cliauth_verify_index_lookup(
+   const struct CliAuthVerifyIndex * index,
+   const struct CliAuthVerifyIndexEntry ** matches,
+   CliAuthUInt32 passcode
+) {
+   const struct CliAuthVerifyIndexEntry * entries;
+   CliAuthUInt32 low, high, middle, first;
+
+   entries = index->entries;
+
+   /* find the first entry which isn't less than the passcode */
+   low = 0;
+   high = index->accounts.count;
+   while (low != high) {
+      middle = low + ((high - low) / 2);
+
+      if (entries[middle].passcode < passcode) {
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+
+   first = low;
+   while (low != index->accounts.count && entries[low].passcode == passcode) {
+      low++;
+   }
+
+   *matches = &entries[first];
+   return low - first;
+}
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+static void
+cliauth_verify_table_thread(void * context) {
+   struct CliAuthVerifyTable * table;
+   void * hash_contexts [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt64 time_current;
+   CliAuthUInt32 i;
+
+   table = (struct CliAuthVerifyTable *)context;
+
+   i = 0;
+   while (i != CLIAUTH_HASH_LANES_MAX) {
+      hash_contexts[i] = &table->hash_contexts[i];
+      i++;
+   }
+
+   cliauth_thread_mutex_lock(&table->mutex);
+   while (table->stopping == CLIAUTH_BOOLEAN_FALSE) {
+      time_current = (CliAuthUInt64)time(CLIAUTH_NULLPTR);
+
+      if (time_current < table->time_refresh) {
+         cliauth_thread_condition_wait_until(
+            &table->condition,
+            &table->mutex,
+            table->time_refresh
+         );
+      } else {
+         /* building takes the lock itself only to publish the new rows */
+         cliauth_thread_mutex_unlock(&table->mutex);
+         (void)cliauth_verify_table_build(
+            table,
+            hash_contexts,
+            time_current,
+            CLIAUTH_BOOLEAN_TRUE
+         );
+         cliauth_thread_mutex_lock(&table->mutex);
+      }
+   }
+   cliauth_thread_mutex_unlock(&table->mutex);
+
+   return;
+}
+
+CliAuthBoolean
+cliauth_verify_table_start(
+   struct CliAuthVerifyTable * table
+) {
+   table->stopping = CLIAUTH_BOOLEAN_FALSE;
+
+   return cliauth_thread_create(
+      &table->thread,
+      cliauth_verify_table_thread,
+      table
+   );
+}
+
+void
+cliauth_verify_table_stop(
+   struct CliAuthVerifyTable * table
+) {
+   cliauth_thread_mutex_lock(&table->mutex);
+   table->stopping = CLIAUTH_BOOLEAN_TRUE;
+   cliauth_thread_condition_broadcast(&table->condition);
+   cliauth_thread_mutex_unlock(&table->mutex);
+
+   cliauth_thread_join(&table->thread);
+   return;
+}
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
@@ -0,0 +1,429 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* src/verify.h - One-time-password verification helpers header.              */
+/*----------------------------------------------------------------------------*/
+
+#ifndef _CLIAUTH_VERIFY_H
+#define _CLIAUTH_VERIFY_H
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+#include "hash.h"
+#include "mac.h"
+#include "otp.h"
+#include "thread.h"
+
+/*----------------------------------------------------------------------------*/
+/* The number of time steps cached per account, which are the previous,       */
+/* current, and next steps.                                                   */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_VERIFY_CACHE_STEPS 3
+
+/*----------------------------------------------------------------------------*/
+/* A single cached account.  The passcodes are stored in step order, so the   */
+/* current step's passcode is in the middle.  Steps before the initial time   */
+/* are stored as a value which no passcode can ever equal.                    */
+/*----------------------------------------------------------------------------*/
+struct CliAuthVerifyCacheEntry {
+   CliAuthUInt64 counter;
+   CliAuthUInt32 passcodes [CLIAUTH_VERIFY_CACHE_STEPS];
+   CliAuthUInt32 account;
+   CliAuthUInt8 digits;
+   CliAuthBoolean valid;
+};
+
+/*----------------------------------------------------------------------------*/
+/* A bounded, direct-mapped cache of TOTP passcodes keyed by account and time */
+/* step.  Each account maps to exactly one entry, which is overwritten on a   */
+/* collision.  Entries are tagged with the step they were computed for, so    */
+/* they go stale on their own when the step rolls over, and a stale entry one */
+/* step behind only needs to compute the new next step.                       */
+/*----------------------------------------------------------------------------*/
+struct CliAuthVerifyCache {
+   struct CliAuthVerifyCacheEntry * entries;
+   CliAuthUInt32 entries_mask;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Initializes an empty cache.                                                */
+/*----------------------------------------------------------------------------*/
+/* cache - The cache to initialize.                                           */
+/*                                                                            */
+/* entries - Caller-owned storage for the cache entries, which must outlive   */
+/*           the cache.                                                       */
+/*                                                                            */
+/* entries_count - The number of entries in 'entries'.  This must be a power  */
+/*                 of two.                                                    */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_cache_initialize(
+   struct CliAuthVerifyCache * cache,
+   struct CliAuthVerifyCacheEntry entries [],
+   CliAuthUInt32 entries_count
+);
+
+/*----------------------------------------------------------------------------*/
+/* Removes an account from the cache.  This must be called whenever an        */
+/* account's key or parameters change.                                        */
+/*----------------------------------------------------------------------------*/
+/* cache - The cache to remove the account from.                              */
+/*                                                                            */
+/* account - The caller-chosen identifier of the account.                     */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_cache_invalidate(
+   struct CliAuthVerifyCache * cache,
+   CliAuthUInt32 account
+);
+
+/*----------------------------------------------------------------------------*/
+/* Verifies a Time-based One Time Password (TOTP) against the previous,       */
+/* current, and next time steps of an account, using the cache to avoid       */
+/* recomputing passcodes which were already computed for the same step.  The  */
+/* results are identical to cliauth_otp_totp_verify() with a window of 1.     */
+/*----------------------------------------------------------------------------*/
+/* cache - The cache to look up and store the account's passcodes in.         */
+/*                                                                            */
+/* hmac_key - The account key, prepared with                                  */
+/*            cliauth_mac_hmac_key_initialize().                              */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for the key's hash */
+/*                 function.                                                  */
+/*                                                                            */
+/* step_matched - Receives the offset of the matched step from the current    */
+/*                step if 'passcode' was found, where negative values are in  */
+/*                the past.  Left unmodified otherwise.                       */
+/*                                                                            */
+/* account - A caller-chosen identifier which is unique to the account.       */
+/*                                                                            */
+/* time_initial - The timestamp to start counting from, in seconds relative   */
+/*                to the Unix epoch.                                          */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to 'time_initial'.                                    */
+/*                                                                            */
+/* time_interval - The interval at which to generate a new password, in       */
+/*                 seconds.  This must be greater than zero.                  */
+/*                                                                            */
+/* passcode - The submitted one-time-password.                                */
+/*                                                                            */
+/* digits - The number of digits, base 10, of the one-time-passwords.  This   */
+/*          must be at least 1, and may not be greater than 9.                */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if 'passcode' matched one of the       */
+/*                steps, otherwise CLIAUTH_BOOLEAN_FALSE.                     */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_verify_totp_cached(
+   struct CliAuthVerifyCache * cache,
+   const struct CliAuthMacHmacKey * hmac_key,
+   void * const hash_contexts [],
+   CliAuthSInt64 * step_matched,
+   CliAuthUInt32 account,
+   CliAuthUInt64 time_initial,
+   CliAuthUInt64 time_current,
+   CliAuthUInt64 time_interval,
+   CliAuthUInt32 passcode,
+   CliAuthUInt8 digits
+);
+
+/*----------------------------------------------------------------------------*/
+/* The number of time steps stored per account in a verification table.  A    */
+/* row built for a target step stores the two steps before it, the target     */
+/* step itself, and the step after it, so lookups are served from the same    */
+/* row both just before and after the target step begins.                     */
+/*----------------------------------------------------------------------------*/
+#define CLIAUTH_VERIFY_TABLE_STEPS 4
+
+/*----------------------------------------------------------------------------*/
+/* The passcodes of a single account in a verification table.  The counter    */
+/* of the first passcode wraps around below zero, and steps which don't exist */
+/* are stored as a value which no passcode can ever equal.                    */
+/*----------------------------------------------------------------------------*/
+struct CliAuthVerifyTableRow {
+   CliAuthUInt64 counter_first;
+   CliAuthUInt32 passcodes [CLIAUTH_VERIFY_TABLE_STEPS];
+};
+
+/*----------------------------------------------------------------------------*/
+/* An eagerly computed table of the previous, current, and next passcodes of  */
+/* a fixed set of TOTP accounts.  Verification is a lookup into the table,    */
+/* which is rebuilt shortly before each account's step boundary.  The rows    */
+/* are double-buffered, so a rebuild never blocks lookups for longer than it  */
+/* takes to swap the buffers, and accounts with different time intervals are  */
+/* only recomputed when their own step rolls over.                            */
+/*                                                                            */
+/* With CLIAUTH_CONFIG_THREADS, the table can be refreshed by a background    */
+/* thread started with cliauth_verify_table_start(), and lookups may be made  */
+/* from any thread.  Otherwise, cliauth_verify_table_refresh() must be called */
+/* by the owner at the times it returns.                                      */
+/*                                                                            */
+/* The fields of this struct should be treated as private.                    */
+/*----------------------------------------------------------------------------*/
+struct CliAuthVerifyTable {
+   struct CliAuthOtpTotpTable accounts;
+   struct CliAuthVerifyTableRow * rows [2];
+   CliAuthUInt32 rows_front;
+   CliAuthUInt64 time_refresh;
+   CliAuthUInt64 time_lead;
+#if CLIAUTH_CONFIG_THREADS
+   union CliAuthOtpBuffersGenericHashContext hash_contexts [CLIAUTH_HASH_LANES_MAX];
+   struct CliAuthThreadMutex mutex;
+   struct CliAuthThreadCondition condition;
+   struct CliAuthThread thread;
+   CliAuthBoolean stopping;
+#endif /* CLIAUTH_CONFIG_THREADS */
+};
+
+/*----------------------------------------------------------------------------*/
+/* Initializes a verification table and builds its rows for the current       */
+/* time.                                                                      */
+/*----------------------------------------------------------------------------*/
+/* table - The verification table to initialize.                              */
+/*                                                                            */
+/* accounts - The set of accounts, which is copied into the table.  The       */
+/*            arrays it points to must outlive the table.                     */
+/*                                                                            */
+/* rows_front - Caller-owned storage for 'accounts->count' rows.              */
+/*                                                                            */
+/* rows_back - Caller-owned storage for another 'accounts->count' rows.       */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every          */
+/*                 account's hash function.                                   */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to every account's initial time.                      */
+/*                                                                            */
+/* time_lead - How many seconds before a step boundary the rows for the next  */
+/*             step are built.  This must be less than every account's time   */
+/*             interval.                                                      */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_table_initialize(
+   struct CliAuthVerifyTable * table,
+   const struct CliAuthOtpTotpTable * accounts,
+   struct CliAuthVerifyTableRow rows_front [],
+   struct CliAuthVerifyTableRow rows_back [],
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current,
+   CliAuthUInt64 time_lead
+);
+
+/*----------------------------------------------------------------------------*/
+/* Releases the resources held by a verification table.  The background       */
+/* thread must not be running.                                                */
+/*----------------------------------------------------------------------------*/
+/* table - The verification table to destroy.                                 */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_table_destroy(
+   struct CliAuthVerifyTable * table
+);
+
+/*----------------------------------------------------------------------------*/
+/* Rebuilds the rows of every account whose step has rolled over, or will     */
+/* within the lead time, then publishes them.  This must not be called while  */
+/* the background thread is running.                                          */
+/*----------------------------------------------------------------------------*/
+/* table - The verification table to refresh.                                 */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every          */
+/*                 account's hash function.                                   */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.                                 */
+/*----------------------------------------------------------------------------*/
+/* Return value - The time the table should next be refreshed at, in seconds  */
+/*                relative to the Unix epoch.                                 */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt64
+cliauth_verify_table_refresh(
+   struct CliAuthVerifyTable * table,
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current
+);
+
+/*----------------------------------------------------------------------------*/
+/* Verifies a Time-based One Time Password (TOTP) of an account against its   */
+/* previous, current, and next time steps.  This is normally a lookup into    */
+/* the table, but if the table has fallen behind, the passcodes are computed  */
+/* on demand instead.  The results are identical to cliauth_otp_totp_verify() */
+/* with a window of 1.                                                        */
+/*----------------------------------------------------------------------------*/
+/* table - The verification table to look up the account in.                  */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for the account's  */
+/*                 hash function.  These are only used when the table has     */
+/*                 fallen behind.                                             */
+/*                                                                            */
+/* step_matched - Receives the offset of the matched step from the current    */
+/*                step if 'passcode' was found, where negative values are in  */
+/*                the past.  Left unmodified otherwise.                       */
+/*                                                                            */
+/* account - The index of the account in the table's account set.             */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to the account's initial time.                        */
+/*                                                                            */
+/* passcode - The submitted one-time-password.                                */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if 'passcode' matched one of the       */
+/*                steps, otherwise CLIAUTH_BOOLEAN_FALSE.                     */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_verify_table_lookup(
+   struct CliAuthVerifyTable * table,
+   void * const hash_contexts [],
+   CliAuthSInt64 * step_matched,
+   CliAuthUInt32 account,
+   CliAuthUInt64 time_current,
+   CliAuthUInt32 passcode
+);
+
+/*----------------------------------------------------------------------------*/
+/* An entry of a verification index, pairing a current passcode with the      */
+/* account which generated it.                                                */
+/*----------------------------------------------------------------------------*/
+struct CliAuthVerifyIndexEntry {
+   CliAuthUInt32 passcode;
+   CliAuthUInt32 account;
+};
+
+/*----------------------------------------------------------------------------*/
+/* A reverse index from the current passcode of every account in a set to     */
+/* the accounts, for verifying passcodes submitted without an account name.   */
+/* The entries are kept sorted by passcode, so a lookup is a binary search.   */
+/* Each refresh only recomputes the accounts whose step rolled over, radix    */
+/* sorts their new entries, and merges them with the entries which are still  */
+/* current.                                                                   */
+/*                                                                            */
+/* Refreshes must not run at the same time as lookups.  The fields of this    */
+/* struct should be treated as private.                                       */
+/*----------------------------------------------------------------------------*/
+struct CliAuthVerifyIndex {
+   struct CliAuthOtpTotpTable accounts;
+   struct CliAuthVerifyIndexEntry * entries;
+   struct CliAuthVerifyIndexEntry * entries_scratch;
+   CliAuthUInt64 * counters;
+};
+
+/*----------------------------------------------------------------------------*/
+/* Initializes a verification index and builds it for the current time.       */
+/*----------------------------------------------------------------------------*/
+/* index - The verification index to initialize.                              */
+/*                                                                            */
+/* accounts - The set of accounts, which is copied into the index.  The       */
+/*            arrays it points to must outlive the index.                     */
+/*                                                                            */
+/* entries - Caller-owned storage for 'accounts->count' entries.              */
+/*                                                                            */
+/* entries_scratch - Caller-owned storage for another 'accounts->count'       */
+/*                   entries, used while refreshing.                          */
+/*                                                                            */
+/* counters - Caller-owned storage for 'accounts->count' counters, which      */
+/*            hold the step each account's entry was computed for.            */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every          */
+/*                 account's hash function.                                   */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.  This must be greater than or   */
+/*                equal to every account's initial time.                      */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_index_initialize(
+   struct CliAuthVerifyIndex * index,
+   const struct CliAuthOtpTotpTable * accounts,
+   struct CliAuthVerifyIndexEntry entries [],
+   struct CliAuthVerifyIndexEntry entries_scratch [],
+   CliAuthUInt64 counters [],
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current
+);
+
+/*----------------------------------------------------------------------------*/
+/* Brings a verification index up to date with the current time.  Only the    */
+/* accounts whose step has rolled over since the last refresh are             */
+/* recomputed.                                                                */
+/*----------------------------------------------------------------------------*/
+/* index - The verification index to refresh.                                 */
+/*                                                                            */
+/* hash_contexts - An array of CLIAUTH_HASH_LANES_MAX pointers to hash        */
+/*                 context structs, each of which is valid for every          */
+/*                 account's hash function.                                   */
+/*                                                                            */
+/* time_current - The timestamp that represents the current time, in seconds  */
+/*                relative to the Unix epoch.                                 */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_index_refresh(
+   struct CliAuthVerifyIndex * index,
+   void * const hash_contexts [],
+   CliAuthUInt64 time_current
+);
+
+/*----------------------------------------------------------------------------*/
+/* Finds every account whose current passcode equals a submitted passcode.    */
+/* Passcodes are compared by value, so accounts with a different number of    */
+/* digits than the submitted passcode should be discarded by the caller.      */
+/*----------------------------------------------------------------------------*/
+/* index - The verification index to search.                                  */
+/*                                                                            */
+/* matches - Receives a pointer to the first matching entry.  The matching    */
+/*           entries are contiguous, and stay valid until the next refresh.   */
+/*                                                                            */
+/* passcode - The submitted one-time-password.                                */
+/*----------------------------------------------------------------------------*/
+/* Return value - The number of matching entries, which may be zero.          */
+/*----------------------------------------------------------------------------*/
+CliAuthUInt32
+cliauth_verify_index_lookup(
+   const struct CliAuthVerifyIndex * index,
+   const struct CliAuthVerifyIndexEntry ** matches,
+   CliAuthUInt32 passcode
+);
+
+#if CLIAUTH_CONFIG_THREADS
+/*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/* Starts a background thread which refreshes the table shortly before each   */
+/* step boundary, using its own hash contexts and the system clock.           */
+/*----------------------------------------------------------------------------*/
+/* table - The verification table to refresh in the background.               */
+/*----------------------------------------------------------------------------*/
+/* Return value - CLIAUTH_BOOLEAN_TRUE if the thread was started, otherwise   */
+/*                CLIAUTH_BOOLEAN_FALSE.                                      */
+/*----------------------------------------------------------------------------*/
+CliAuthBoolean
+cliauth_verify_table_start(
+   struct CliAuthVerifyTable * table
+);
+
+/*----------------------------------------------------------------------------*/
+/* Stops the background thread started with cliauth_verify_table_start() and  */
+/* waits for it to exit.                                                      */
+/*----------------------------------------------------------------------------*/
+/* table - The verification table being refreshed in the background.          */
+/*----------------------------------------------------------------------------*/
+void
+cliauth_verify_table_stop(
+   struct CliAuthVerifyTable * table
+);
+
+/*----------------------------------------------------------------------------*/
+#endif /* CLIAUTH_CONFIG_THREADS */
+
+/*----------------------------------------------------------------------------*/
+#endif /* _CLIAUTH_VERIFY_H */
+
@@ -0,0 +1,429 @@
+/*----------------------------------------------------------------------------*/
+/*                         Copyright (c) CliAuth 2024                         */
+/*                   https://github.com/bradleycha/cliauth                    */
+/*----------------------------------------------------------------------------*/
+/* test/hash_lanes.c - Hash lane manager tests                                */
+/*----------------------------------------------------------------------------*/
+
+#include "cliauth.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cpu.h"
+#include "hash.h"
+#include "otp.h"
+
+struct CliAuthTestHash {
+   const char * name;
+   const struct CliAuthHashFunction * function;
+   CliAuthUInt32 block_bytes;
+   CliAuthUInt32 digest_bytes;
+};
+
+static const struct CliAuthTestHash
+cliauth_test_hashes [] = {
+#if CLIAUTH_CONFIG_HASH_SHA1
+   {
+      "sha1",
+      &cliauth_hash_sha1,
+      CLIAUTH_HASH_SHA1_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA1_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA1 */
+#if CLIAUTH_CONFIG_HASH_SHA224
+   {
+      "sha224",
+      &cliauth_hash_sha224,
+      CLIAUTH_HASH_SHA224_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA224_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA224 */
+#if CLIAUTH_CONFIG_HASH_SHA256
+   {
+      "sha256",
+      &cliauth_hash_sha256,
+      CLIAUTH_HASH_SHA256_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA256_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA256 */
+#if CLIAUTH_CONFIG_HASH_SHA384
+   {
+      "sha384",
+      &cliauth_hash_sha384,
+      CLIAUTH_HASH_SHA384_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA384_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA384 */
+#if CLIAUTH_CONFIG_HASH_SHA512
+   {
+      "sha512",
+      &cliauth_hash_sha512,
+      CLIAUTH_HASH_SHA512_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA512_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA512 */
+#if CLIAUTH_CONFIG_HASH_SHA512_224
+   {
+      "sha512/224",
+      &cliauth_hash_sha512_224,
+      CLIAUTH_HASH_SHA512_224_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA512_224_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_224 */
+#if CLIAUTH_CONFIG_HASH_SHA512_256
+   {
+      "sha512/256",
+      &cliauth_hash_sha512_256,
+      CLIAUTH_HASH_SHA512_256_INPUT_BLOCK_LENGTH,
+      CLIAUTH_HASH_SHA512_256_DIGEST_LENGTH
+   },
+#endif /* CLIAUTH_CONFIG_HASH_SHA512_256 */
+};
+
+#define CLIAUTH_TEST_HASHES_COUNT\
+   (sizeof(cliauth_test_hashes) / sizeof(cliauth_test_hashes[0]))
+
+/* message lengths of the submitted jobs.  long jobs are mixed in with */
+/* 8-byte OTP counters, empty messages, and messages ending exactly on a */
+/* block boundary, so jobs complete out of order and tails of several */
+/* lengths are left in the lanes at once. */
+static const CliAuthUInt32
+cliauth_test_message_lengths [] = {
+   1000, 8, 300, 8, 0, 128, 8, 20, 8, 8, 64, 500,
+   8, 129, 8, 8, 8, 255, 8, 8, 1, 8, 640, 8
+};
+
+#define CLIAUTH_TEST_JOBS_COUNT (\
+      sizeof(cliauth_test_message_lengths) /\
+      sizeof(cliauth_test_message_lengths[0])\
+   )
+
+#define CLIAUTH_TEST_MESSAGE_BYTES 1024
+
+/* the largest digest of any hash function */
+#define CLIAUTH_TEST_DIGEST_BYTES 64
+
+struct CliAuthTestState {
+   const struct CliAuthTestHash * hash;
+   struct CliAuthHashLanes lanes;
+   struct CliAuthHashJob jobs [CLIAUTH_HASH_LANES_MAX];
+   union CliAuthOtpBuffersGenericHashContext
+      contexts [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt8
+      digests [CLIAUTH_HASH_LANES_MAX][CLIAUTH_TEST_DIGEST_BYTES];
+
+   /* the index of the message hashed by each job */
+   CliAuthUInt32 jobs_message [CLIAUTH_HASH_LANES_MAX];
+
+   /* the jobs which aren't held by the lane manager */
+   CliAuthUInt32 jobs_free [CLIAUTH_HASH_LANES_MAX];
+   CliAuthUInt32 jobs_free_count;
+
+   /* the number of times each message has completed */
+   CliAuthUInt32 completions [CLIAUTH_TEST_JOBS_COUNT];
+
+   /* whether a message completed before one which was submitted earlier */
+   CliAuthBoolean out_of_order;
+   CliAuthUInt32 message_last;
+
+   CliAuthUInt32 failures;
+};
+
+static CliAuthUInt8
+cliauth_test_message [CLIAUTH_TEST_MESSAGE_BYTES];
+
+static void
+cliauth_test_fail(
+   struct CliAuthTestState * state,
+   const char * test,
+   const char * reason
+) {
+   (void)fprintf(stderr, "%s: %s: %s\n", state->hash->name, test, reason);
+   state->failures++;
+   return;
+}
+
+/* each message starts at a different offset, so no two are identical */
+static const CliAuthUInt8 *
+cliauth_test_message_start(
+   CliAuthUInt32 message
+) {
+   return &cliauth_test_message[message];
+}
+
+static void
+cliauth_test_reset(
+   struct CliAuthTestState * state,
+   const struct CliAuthTestHash * hash
+) {
+   CliAuthUInt32 i;
+
+   state->hash = hash;
+   cliauth_hash_lanes_initialize(
+      &state->lanes,
+      hash->function,
+      hash->block_bytes
+   );
+
+   i = 0;
+   while (i != CLIAUTH_HASH_LANES_MAX) {
+      state->jobs[i].context = &state->contexts[i];
+      state->jobs[i].digest = state->digests[i];
+      state->jobs_free[i] = i;
+      i++;
+   }
+   state->jobs_free_count = CLIAUTH_HASH_LANES_MAX;
+
+   i = 0;
+   while (i != CLIAUTH_TEST_JOBS_COUNT) {
+      state->completions[i] = 0;
+      i++;
+   }
+
+   state->out_of_order = CLIAUTH_BOOLEAN_FALSE;
+   state->message_last = 0;
+
+   return;
+}
+
+static void
+cliauth_test_submit(
+   struct CliAuthTestState * state,
+   CliAuthUInt32 message
+) {
+   struct CliAuthHashJob * job;
+   CliAuthUInt32 index;
+
+   state->jobs_free_count--;
+   index = state->jobs_free[state->jobs_free_count];
+   job = &state->jobs[index];
+
+   state->hash->function->initialize(job->context);
+   job->message = cliauth_test_message_start(message);
+   job->message_bytes = cliauth_test_message_lengths[message];
+   state->jobs_message[index] = message;
+
+   cliauth_hash_lanes_submit(&state->lanes, job);
+   return;
+}
+
+/* checks a completed job against hashing its message in one go */
+static void
+cliauth_test_check(
+   struct CliAuthTestState * state,
+   const char * test,
+   struct CliAuthHashJob * job
+) {
+   union CliAuthOtpBuffersGenericHashContext context;
+   CliAuthUInt8 digest [CLIAUTH_TEST_DIGEST_BYTES];
+   CliAuthUInt32 index, message;
+
+   index = (CliAuthUInt32)(job - state->jobs);
+   message = state->jobs_message[index];
+
+   state->hash->function->initialize(&context);
+   state->hash->function->digest(
+      &context,
+      cliauth_test_message_start(message),
+      cliauth_test_message_lengths[message]
+   );
+   state->hash->function->finalize(&context, digest);
+
+   if (memcmp(digest, job->digest, state->hash->digest_bytes) != 0) {
+      cliauth_test_fail(state, test, "digest mismatch");
+   }
+
+   if (message < state->message_last) {
+      state->out_of_order = CLIAUTH_BOOLEAN_TRUE;
+   }
+   state->message_last = message;
+
+   state->completions[message]++;
+   state->jobs_free[state->jobs_free_count] = index;
+   state->jobs_free_count++;
+
+   return;
+}
+
+static void
+cliauth_test_check_completions(
+   struct CliAuthTestState * state,
+   const char * test,
+   CliAuthUInt32 count
+) {
+   CliAuthUInt32 i;
+
+   i = 0;
+   while (i != count) {
+      if (state->completions[i] != 1) {
+         cliauth_test_fail(state, test, "job not completed exactly once");
+      }
+      i++;
+   }
+
+   return;
+}
+
+/* submits every job, taking completed jobs as soon as they're available, */
+/* then flushes the rest.  with jobs of mixed lengths, short jobs finish */
+/* before long jobs submitted ahead of them. */
+static void
+cliauth_test_any_order(
+   struct CliAuthTestState * state,
+   const struct CliAuthTestHash * hash
+) {
+   struct CliAuthHashJob * job;
+   CliAuthUInt32 i;
+
+   cliauth_test_reset(state, hash);
+
+   i = 0;
+   while (i != CLIAUTH_TEST_JOBS_COUNT) {
+      cliauth_test_submit(state, i);
+
+      job = cliauth_hash_lanes_complete(&state->lanes);
+      while (job != CLIAUTH_NULLPTR) {
+         cliauth_test_check(state, "any order", job);
+         job = cliauth_hash_lanes_complete(&state->lanes);
+      }
+
+      i++;
+   }
+
+   job = cliauth_hash_lanes_flush(&state->lanes);
+   while (job != CLIAUTH_NULLPTR) {
+      cliauth_test_check(state, "any order", job);
+      job = cliauth_hash_lanes_flush(&state->lanes);
+   }
+
+   cliauth_test_check_completions(state, "any order", CLIAUTH_TEST_JOBS_COUNT);
+
+   if (state->out_of_order == CLIAUTH_BOOLEAN_FALSE) {
+      cliauth_test_fail(
+         state,
+         "any order",
+         "jobs completed in submission order"
+      );
+   }
+
+   return;
+}
+
+/* partially filled lanes only run when flushed */
+static void
+cliauth_test_flush(
+   struct CliAuthTestState * state,
+   const struct CliAuthTestHash * hash
+) {
+   struct CliAuthHashJob * job;
+
+   cliauth_test_reset(state, hash);
+
+   cliauth_test_submit(state, 0);
+   cliauth_test_submit(state, 1);
+   cliauth_test_submit(state, 2);
+
+   if (cliauth_hash_lanes_complete(&state->lanes) != CLIAUTH_NULLPTR) {
+      cliauth_test_fail(state, "flush", "job completed before flushing");
+   }
+
+   job = cliauth_hash_lanes_flush(&state->lanes);
+   while (job != CLIAUTH_NULLPTR) {
+      cliauth_test_check(state, "flush", job);
+      job = cliauth_hash_lanes_flush(&state->lanes);
+   }
+
+   cliauth_test_check_completions(state, "flush", 3);
+
+   return;
+}
+
+/* jobs without full blocks wait for every lane to fill, then all finish */
+/* together in one multi-lane final block */
+static void
+cliauth_test_shared_tail(
+   struct CliAuthTestState * state,
+   const struct CliAuthTestHash * hash
+) {
+   struct CliAuthHashJob * job;
+   CliAuthUInt32 completed, i;
+
+   cliauth_test_reset(state, hash);
+
+   i = 0;
+   while (i != CLIAUTH_HASH_LANES_MAX - 1) {
+      cliauth_test_submit(state, 1);
+
+      if (cliauth_hash_lanes_complete(&state->lanes) != CLIAUTH_NULLPTR) {
+         cliauth_test_fail(
+            state,
+            "shared tail",
+            "job completed before the lanes filled"
+         );
+      }
+
+      i++;
+   }
+
+   cliauth_test_submit(state, 1);
+
+   completed = 0;
+   job = cliauth_hash_lanes_complete(&state->lanes);
+   while (job != CLIAUTH_NULLPTR) {
+      cliauth_test_check(state, "shared tail", job);
+      completed++;
+      job = cliauth_hash_lanes_complete(&state->lanes);
+   }
+
+   if (completed != CLIAUTH_HASH_LANES_MAX) {
+      cliauth_test_fail(state, "shared tail", "jobs didn't finish together");
+   }
+
+   if (cliauth_hash_lanes_flush(&state->lanes) != CLIAUTH_NULLPTR) {
+      cliauth_test_fail(state, "shared tail", "job left after completing");
+   }
+
+   return;
+}
+
+int
+main(void) {
+   static struct CliAuthTestState state;
+   CliAuthUInt32 failures;
+   CliAuthUInt32 i;
+
+   cliauth_cpu_initialize();
+   cliauth_hash_initialize();
+
+   i = 0;
+   while (i != CLIAUTH_TEST_MESSAGE_BYTES) {
+      cliauth_test_message[i] = (CliAuthUInt8)(i * 131 + 7);
+      i++;
+   }
+
+   failures = 0;
+   i = 0;
+   while (i != CLIAUTH_TEST_HASHES_COUNT) {
+      state.failures = 0;
+
+      cliauth_test_any_order(&state, &cliauth_test_hashes[i]);
+      cliauth_test_flush(&state, &cliauth_test_hashes[i]);
+      cliauth_test_shared_tail(&state, &cliauth_test_hashes[i]);
+
+      (void)printf(
+         "%s: %s\n",
+         cliauth_test_hashes[i].name,
+         state.failures == 0 ? "ok" : "FAILED"
+      );
+
+      failures += state.failures;
+      i++;
+   }
+
+   if (failures != 0) {
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}